@@ -0,0 +1,383 @@
+/*
+ * GStreamer - gst.wasm WebSimd source
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Pixel format kernels for the conversions the browser can not do in
+ * VideoFrame.copyTo() or new VideoFrame(). Every kernel has a wasm SIMD128
+ * path, used when built with -msimd128, and a scalar one for the leftovers
+ * of every row and for builds without SIMD support.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#include "gstwebsimd.h"
+
+static gboolean
+gst_web_simd_is_rgb32 (
+    GstVideoFormat format, gboolean *has_alpha, gboolean *is_bgr)
+{
+  switch (format) {
+    case GST_VIDEO_FORMAT_RGBA:
+    case GST_VIDEO_FORMAT_RGBx:
+      *is_bgr = FALSE;
+      break;
+    case GST_VIDEO_FORMAT_BGRA:
+    case GST_VIDEO_FORMAT_BGRx:
+      *is_bgr = TRUE;
+      break;
+    default:
+      return FALSE;
+  }
+
+  *has_alpha =
+      format == GST_VIDEO_FORMAT_RGBA || format == GST_VIDEO_FORMAT_BGRA;
+  return TRUE;
+}
+
+static void
+gst_web_simd_copy_plane (const GstVideoFrame *in, GstVideoFrame *out,
+    guint plane, gsize row_size)
+{
+  const guint8 *src = GST_VIDEO_FRAME_PLANE_DATA (in, plane);
+  guint8 *dest = GST_VIDEO_FRAME_PLANE_DATA (out, plane);
+  gint src_stride = GST_VIDEO_FRAME_PLANE_STRIDE (in, plane);
+  gint dest_stride = GST_VIDEO_FRAME_PLANE_STRIDE (out, plane);
+  gint height = GST_VIDEO_FRAME_COMP_HEIGHT (out, plane);
+  gint i;
+
+  for (i = 0; i < height; i++)
+    memcpy (dest + i * dest_stride, src + i * src_stride, row_size);
+}
+
+static void
+gst_web_simd_nv12_to_i420 (const GstVideoFrame *in, GstVideoFrame *out)
+{
+  const guint8 *uv = GST_VIDEO_FRAME_PLANE_DATA (in, 1);
+  guint8 *u = GST_VIDEO_FRAME_PLANE_DATA (out, 1);
+  guint8 *v = GST_VIDEO_FRAME_PLANE_DATA (out, 2);
+  gint uv_stride = GST_VIDEO_FRAME_PLANE_STRIDE (in, 1);
+  gint u_stride = GST_VIDEO_FRAME_PLANE_STRIDE (out, 1);
+  gint v_stride = GST_VIDEO_FRAME_PLANE_STRIDE (out, 2);
+  gint width = GST_VIDEO_FRAME_COMP_WIDTH (out, 1);
+  gint height = GST_VIDEO_FRAME_COMP_HEIGHT (out, 1);
+  gint i;
+
+  gst_web_simd_copy_plane (in, out, 0, GST_VIDEO_FRAME_WIDTH (out));
+  for (i = 0; i < height; i++) {
+    gst_web_simd_deinterleave_uv (
+        uv + i * uv_stride, u + i * u_stride, v + i * v_stride, width);
+  }
+}
+
+static void
+gst_web_simd_i420_to_nv12 (const GstVideoFrame *in, GstVideoFrame *out)
+{
+  const guint8 *u = GST_VIDEO_FRAME_PLANE_DATA (in, 1);
+  const guint8 *v = GST_VIDEO_FRAME_PLANE_DATA (in, 2);
+  guint8 *uv = GST_VIDEO_FRAME_PLANE_DATA (out, 1);
+  gint u_stride = GST_VIDEO_FRAME_PLANE_STRIDE (in, 1);
+  gint v_stride = GST_VIDEO_FRAME_PLANE_STRIDE (in, 2);
+  gint uv_stride = GST_VIDEO_FRAME_PLANE_STRIDE (out, 1);
+  gint width = GST_VIDEO_FRAME_COMP_WIDTH (in, 1);
+  gint height = GST_VIDEO_FRAME_COMP_HEIGHT (in, 1);
+  gint i;
+
+  gst_web_simd_copy_plane (in, out, 0, GST_VIDEO_FRAME_WIDTH (out));
+  for (i = 0; i < height; i++) {
+    gst_web_simd_interleave_uv (
+        u + i * u_stride, v + i * v_stride, uv + i * uv_stride, width);
+  }
+}
+
+static void
+gst_web_simd_i420_10le_to_i420 (const GstVideoFrame *in, GstVideoFrame *out)
+{
+  guint plane;
+
+  for (plane = 0; plane < 3; plane++) {
+    const guint8 *src = GST_VIDEO_FRAME_PLANE_DATA (in, plane);
+    guint8 *dest = GST_VIDEO_FRAME_PLANE_DATA (out, plane);
+    gint src_stride = GST_VIDEO_FRAME_PLANE_STRIDE (in, plane);
+    gint dest_stride = GST_VIDEO_FRAME_PLANE_STRIDE (out, plane);
+    gint width = GST_VIDEO_FRAME_COMP_WIDTH (out, plane);
+    gint height = GST_VIDEO_FRAME_COMP_HEIGHT (out, plane);
+    gint i;
+
+    for (i = 0; i < height; i++) {
+      gst_web_simd_unpack_10le ((const guint16 *) (src + i * src_stride),
+          dest + i * dest_stride, width);
+    }
+  }
+}
+
+static void
+gst_web_simd_rgb32_to_rgb32 (const GstVideoFrame *in, GstVideoFrame *out,
+    gboolean swap, gboolean fill)
+{
+  const guint8 *src = GST_VIDEO_FRAME_PLANE_DATA (in, 0);
+  guint8 *dest = GST_VIDEO_FRAME_PLANE_DATA (out, 0);
+  gint src_stride = GST_VIDEO_FRAME_PLANE_STRIDE (in, 0);
+  gint dest_stride = GST_VIDEO_FRAME_PLANE_STRIDE (out, 0);
+  gint width = GST_VIDEO_FRAME_WIDTH (out);
+  gint height = GST_VIDEO_FRAME_HEIGHT (out);
+  gint i;
+
+  for (i = 0; i < height; i++) {
+    const guint8 *s = src + i * src_stride;
+    guint8 *d = dest + i * dest_stride;
+
+    if (swap)
+      gst_web_simd_swap_rb (s, d, width);
+    else
+      memcpy (d, s, width * 4);
+    if (fill)
+      gst_web_simd_fill_alpha (d, width);
+  }
+}
+
+/**
+ * gst_web_simd_is_accelerated:
+ *
+ * Returns: %TRUE if the kernels were built with wasm SIMD128 support
+ */
+gboolean
+gst_web_simd_is_accelerated (void)
+{
+#ifdef __wasm_simd128__
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/**
+ * gst_web_simd_deinterleave_uv:
+ * @uv: the interleaved UV samples, 2 * @n bytes
+ * @u: the U samples to fill, @n bytes
+ * @v: the V samples to fill, @n bytes
+ * @n: the number of sample pairs
+ */
+void
+gst_web_simd_deinterleave_uv (const guint8 *uv, guint8 *u, guint8 *v, gsize n)
+{
+  gsize i = 0;
+
+#ifdef __wasm_simd128__
+  for (; i + 16 <= n; i += 16) {
+    v128_t a = wasm_v128_load (uv + 2 * i);
+    v128_t b = wasm_v128_load (uv + 2 * i + 16);
+
+    wasm_v128_store (u + i, wasm_i8x16_shuffle (a, b, 0, 2, 4, 6, 8, 10, 12,
+                                14, 16, 18, 20, 22, 24, 26, 28, 30));
+    wasm_v128_store (v + i, wasm_i8x16_shuffle (a, b, 1, 3, 5, 7, 9, 11, 13,
+                                15, 17, 19, 21, 23, 25, 27, 29, 31));
+  }
+#endif
+  for (; i < n; i++) {
+    u[i] = uv[2 * i];
+    v[i] = uv[2 * i + 1];
+  }
+}
+
+/**
+ * gst_web_simd_interleave_uv:
+ * @u: the U samples, @n bytes
+ * @v: the V samples, @n bytes
+ * @uv: the interleaved UV samples to fill, 2 * @n bytes
+ * @n: the number of sample pairs
+ */
+void
+gst_web_simd_interleave_uv (
+    const guint8 *u, const guint8 *v, guint8 *uv, gsize n)
+{
+  gsize i = 0;
+
+#ifdef __wasm_simd128__
+  for (; i + 16 <= n; i += 16) {
+    v128_t a = wasm_v128_load (u + i);
+    v128_t b = wasm_v128_load (v + i);
+
+    wasm_v128_store (uv + 2 * i, wasm_i8x16_shuffle (a, b, 0, 16, 1, 17, 2,
+                                     18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23));
+    wasm_v128_store (uv + 2 * i + 16,
+        wasm_i8x16_shuffle (a, b, 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13,
+            29, 14, 30, 15, 31));
+  }
+#endif
+  for (; i < n; i++) {
+    uv[2 * i] = u[i];
+    uv[2 * i + 1] = v[i];
+  }
+}
+
+/**
+ * gst_web_simd_swap_rb:
+ * @src: the RGBA or BGRA pixels
+ * @dest: the pixels to fill, can be @src
+ * @n: the number of pixels
+ *
+ * Swaps the first and third byte of every 4 bytes pixel, converting RGBA
+ * into BGRA and the other way around.
+ */
+void
+gst_web_simd_swap_rb (const guint8 *src, guint8 *dest, gsize n)
+{
+  gsize i = 0;
+
+#ifdef __wasm_simd128__
+  for (; i + 4 <= n; i += 4) {
+    v128_t a = wasm_v128_load (src + 4 * i);
+
+    wasm_v128_store (dest + 4 * i, wasm_i8x16_shuffle (a, a, 2, 1, 0, 3, 6,
+                                       5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+  }
+#endif
+  for (; i < n; i++) {
+    guint8 r = src[4 * i];
+
+    dest[4 * i] = src[4 * i + 2];
+    dest[4 * i + 1] = src[4 * i + 1];
+    dest[4 * i + 2] = r;
+    dest[4 * i + 3] = src[4 * i + 3];
+  }
+}
+
+/**
+ * gst_web_simd_fill_alpha:
+ * @data: the RGBx or BGRx pixels
+ * @n: the number of pixels
+ *
+ * Sets the fourth byte of every 4 bytes pixel to opaque.
+ */
+void
+gst_web_simd_fill_alpha (guint8 *data, gsize n)
+{
+  gsize i = 0;
+
+#ifdef __wasm_simd128__
+  const v128_t alpha = wasm_i32x4_splat ((gint32) 0xff000000);
+
+  for (; i + 4 <= n; i += 4) {
+    v128_t a = wasm_v128_load (data + 4 * i);
+
+    wasm_v128_store (data + 4 * i, wasm_v128_or (a, alpha));
+  }
+#endif
+  for (; i < n; i++)
+    data[4 * i + 3] = 0xff;
+}
+
+/**
+ * gst_web_simd_unpack_10le:
+ * @src: the 10 bits samples, stored in the low bits of 16 bits little endian
+ * words
+ * @dest: the 8 bits samples to fill
+ * @n: the number of samples
+ */
+void
+gst_web_simd_unpack_10le (const guint16 *src, guint8 *dest, gsize n)
+{
+  gsize i = 0;
+
+#ifdef __wasm_simd128__
+  for (; i + 16 <= n; i += 16) {
+    v128_t a = wasm_u16x8_shr (wasm_v128_load (src + i), 2);
+    v128_t b = wasm_u16x8_shr (wasm_v128_load (src + i + 8), 2);
+
+    wasm_v128_store (dest + i, wasm_u8x16_narrow_i16x8 (a, b));
+  }
+#endif
+  for (; i < n; i++)
+    dest[i] = MIN (GUINT16_FROM_LE (src[i]) >> 2, 255);
+}
+
+/**
+ * gst_web_simd_can_convert:
+ * @in_format: the format to convert from
+ * @out_format: the format to convert to
+ *
+ * Returns: %TRUE if gst_web_simd_convert_frame() handles the conversion
+ */
+gboolean
+gst_web_simd_can_convert (GstVideoFormat in_format, GstVideoFormat out_format)
+{
+  gboolean in_alpha, in_bgr, out_alpha, out_bgr;
+
+  if (gst_web_simd_is_rgb32 (in_format, &in_alpha, &in_bgr) &&
+      gst_web_simd_is_rgb32 (out_format, &out_alpha, &out_bgr))
+    return TRUE;
+
+  return (in_format == GST_VIDEO_FORMAT_NV12 &&
+             out_format == GST_VIDEO_FORMAT_I420) ||
+         (in_format == GST_VIDEO_FORMAT_I420 &&
+             out_format == GST_VIDEO_FORMAT_NV12) ||
+         (in_format == GST_VIDEO_FORMAT_I420_10LE &&
+             out_format == GST_VIDEO_FORMAT_I420);
+}
+
+/**
+ * gst_web_simd_convert_frame:
+ * @in: the frame to convert from
+ * @out: the frame to convert to, of the same size
+ *
+ * Converts between NV12 and I420, swizzles and fills the alpha of the 32 bits
+ * RGB formats and unpacks I420_10LE into I420.
+ *
+ * Returns: %FALSE if the conversion is not handled, @out is left untouched
+ */
+gboolean
+gst_web_simd_convert_frame (const GstVideoFrame *in, GstVideoFrame *out)
+{
+  GstVideoFormat in_format = GST_VIDEO_FRAME_FORMAT (in);
+  GstVideoFormat out_format = GST_VIDEO_FRAME_FORMAT (out);
+  gboolean in_alpha, in_bgr, out_alpha, out_bgr;
+
+  if (GST_VIDEO_FRAME_WIDTH (in) != GST_VIDEO_FRAME_WIDTH (out) ||
+      GST_VIDEO_FRAME_HEIGHT (in) != GST_VIDEO_FRAME_HEIGHT (out))
+    return FALSE;
+
+  if (gst_web_simd_is_rgb32 (in_format, &in_alpha, &in_bgr) &&
+      gst_web_simd_is_rgb32 (out_format, &out_alpha, &out_bgr)) {
+    gst_web_simd_rgb32_to_rgb32 (
+        in, out, in_bgr != out_bgr, out_alpha && !in_alpha);
+  } else if (in_format == GST_VIDEO_FORMAT_NV12 &&
+             out_format == GST_VIDEO_FORMAT_I420) {
+    gst_web_simd_nv12_to_i420 (in, out);
+  } else if (in_format == GST_VIDEO_FORMAT_I420 &&
+             out_format == GST_VIDEO_FORMAT_NV12) {
+    gst_web_simd_i420_to_nv12 (in, out);
+  } else if (in_format == GST_VIDEO_FORMAT_I420_10LE &&
+             out_format == GST_VIDEO_FORMAT_I420) {
+    gst_web_simd_i420_10le_to_i420 (in, out);
+  } else {
+    return FALSE;
+  }
+
+  return TRUE;
+}
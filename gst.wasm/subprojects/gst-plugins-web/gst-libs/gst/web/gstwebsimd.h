@@ -0,0 +1,47 @@
+/*
+ * GStreamer - gst.wasm WebSimd source
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __GST_WEB_SIMD_H__
+#define __GST_WEB_SIMD_H__
+
+#include <gst/video/video.h>
+
+G_BEGIN_DECLS
+
+gboolean gst_web_simd_is_accelerated (void);
+
+void gst_web_simd_deinterleave_uv (
+    const guint8 *uv, guint8 *u, guint8 *v, gsize n);
+void gst_web_simd_interleave_uv (
+    const guint8 *u, const guint8 *v, guint8 *uv, gsize n);
+void gst_web_simd_swap_rb (const guint8 *src, guint8 *dest, gsize n);
+void gst_web_simd_fill_alpha (guint8 *data, gsize n);
+void gst_web_simd_unpack_10le (const guint16 *src, guint8 *dest, gsize n);
+
+gboolean gst_web_simd_can_convert (
+    GstVideoFormat in_format, GstVideoFormat out_format);
+gboolean gst_web_simd_convert_frame (
+    const GstVideoFrame *in, GstVideoFrame *out);
+
+G_END_DECLS
+
+#endif /* __GST_WEB_SIMD_H__ */
@@ -28,6 +28,7 @@
 #include <emscripten.h>
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
+#include <gst/video/gstvideometa.h>
 
 #include "gstwebcanvas.h"
 #include "gstwebutils.h"
@@ -490,3 +491,139 @@ gst_web_utils_video_format_to_web_format (GstVideoFormat format)
 
   return vf_format;
 }
+
+/**
+ * gst_web_utils_video_colorimetry_to_web_color_space:
+ * @colorimetry: a #GstVideoColorimetry
+ *
+ * Converts @colorimetry into a VideoColorSpaceInit dictionary. Members that
+ * have no WebCodecs equivalent are left unset.
+ *
+ * Returns: the VideoColorSpaceInit
+ */
+val
+gst_web_utils_video_colorimetry_to_web_color_space (
+    const GstVideoColorimetry *colorimetry)
+{
+  val color_space = val::object ();
+
+  switch (colorimetry->primaries) {
+    case GST_VIDEO_COLOR_PRIMARIES_BT709:
+      color_space.set ("primaries", "bt709");
+      break;
+    case GST_VIDEO_COLOR_PRIMARIES_BT470BG:
+      color_space.set ("primaries", "bt470bg");
+      break;
+    case GST_VIDEO_COLOR_PRIMARIES_SMPTE170M:
+      color_space.set ("primaries", "smpte170m");
+      break;
+    case GST_VIDEO_COLOR_PRIMARIES_BT2020:
+      color_space.set ("primaries", "bt2020");
+      break;
+    case GST_VIDEO_COLOR_PRIMARIES_SMPTEEG432:
+      color_space.set ("primaries", "smpte432");
+      break;
+    default:
+      break;
+  }
+
+  switch (colorimetry->transfer) {
+    case GST_VIDEO_TRANSFER_BT709:
+      color_space.set ("transfer", "bt709");
+      break;
+    case GST_VIDEO_TRANSFER_BT601:
+      color_space.set ("transfer", "smpte170m");
+      break;
+    case GST_VIDEO_TRANSFER_SRGB:
+      color_space.set ("transfer", "iec61966-2-1");
+      break;
+    case GST_VIDEO_TRANSFER_GAMMA10:
+      color_space.set ("transfer", "linear");
+      break;
+    case GST_VIDEO_TRANSFER_SMPTE2084:
+      color_space.set ("transfer", "pq");
+      break;
+    case GST_VIDEO_TRANSFER_ARIB_STD_B67:
+      color_space.set ("transfer", "hlg");
+      break;
+    default:
+      break;
+  }
+
+  switch (colorimetry->matrix) {
+    case GST_VIDEO_COLOR_MATRIX_RGB:
+      color_space.set ("matrix", "rgb");
+      break;
+    case GST_VIDEO_COLOR_MATRIX_BT709:
+      color_space.set ("matrix", "bt709");
+      break;
+    case GST_VIDEO_COLOR_MATRIX_BT601:
+      color_space.set ("matrix", "smpte170m");
+      break;
+    case GST_VIDEO_COLOR_MATRIX_BT2020:
+      color_space.set ("matrix", "bt2020-ncl");
+      break;
+    default:
+      break;
+  }
+
+  if (colorimetry->range != GST_VIDEO_COLOR_RANGE_UNKNOWN)
+    color_space.set (
+        "fullRange", colorimetry->range == GST_VIDEO_COLOR_RANGE_0_255);
+
+  return color_space;
+}
+
+/**
+ * gst_web_utils_video_frame_new:
+ * @buffer: the #GstBuffer @data belongs to
+ * @info: the #GstVideoInfo of @buffer
+ * @data: the mapped data of @buffer
+ * @size: the size of @data
+ *
+ * Creates a VideoFrame of @data, laid out as the #GstVideoMeta of @buffer
+ * says, or as @info if there is none, with the timestamps of @buffer.
+ * @data is copied once, by the VideoFrame constructor.
+ *
+ * Returns: the VideoFrame
+ */
+val
+gst_web_utils_video_frame_new (
+    GstBuffer *buffer, const GstVideoInfo *info, guint8 *data, gsize size)
+{
+  GstVideoMeta *meta = gst_buffer_get_video_meta (buffer);
+  val layout = val::array ();
+  val init = val::object ();
+  guint i;
+
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (info); i++) {
+    val plane = val::object ();
+
+    if (meta) {
+      plane.set ("offset", (guint) meta->offset[i]);
+      plane.set ("stride", meta->stride[i]);
+    } else {
+      plane.set ("offset", (guint) GST_VIDEO_INFO_PLANE_OFFSET (info, i));
+      plane.set ("stride", GST_VIDEO_INFO_PLANE_STRIDE (info, i));
+    }
+    layout.call<void> ("push", plane);
+  }
+
+  init.set ("format", val (gst_web_utils_video_format_to_web_format (
+                          GST_VIDEO_INFO_FORMAT (info))));
+  init.set ("codedWidth", meta ? meta->width : GST_VIDEO_INFO_WIDTH (info));
+  init.set (
+      "codedHeight", meta ? meta->height : GST_VIDEO_INFO_HEIGHT (info));
+  init.set ("layout", layout);
+  /* In microseconds */
+  init.set ("timestamp", GST_BUFFER_PTS_IS_VALID (buffer)
+                             ? (gdouble) GST_BUFFER_PTS (buffer) / GST_USECOND
+                             : 0.0);
+  if (GST_BUFFER_DURATION_IS_VALID (buffer)) {
+    init.set (
+        "duration", (gdouble) GST_BUFFER_DURATION (buffer) / GST_USECOND);
+  }
+
+  return val::global ("VideoFrame")
+      .new_ (val (typed_memory_view (size, data)), init);
+}
@@ -58,6 +58,10 @@ G_END_DECLS
 
 GByteArray gst_web_utils_copy_data_from_js (const emscripten::val &data);
 GstBuffer *gst_web_utils_js_array_to_buffer (const emscripten::val &data);
+emscripten::val gst_web_utils_video_colorimetry_to_web_color_space (
+    const GstVideoColorimetry *colorimetry);
+emscripten::val gst_web_utils_video_frame_new (
+    GstBuffer *buffer, const GstVideoInfo *info, guint8 *data, gsize size);
 #endif
 
 #endif
@@ -92,12 +92,41 @@ typedef struct _GstWebVideoFrameAllocatorMapCpuData
   gboolean result;
 } GstWebVideoFrameAllocatorMapCpuData;
 
+typedef struct _GstWebVideoFrameCopyAsyncData
+{
+  GstWebVideoFrame *self;
+  GstVideoInfo info;
+  guint8 *data;
+  gsize size;
+  GstWebVideoFrameCopyFunc func;
+  gpointer user_data;
+} GstWebVideoFrameCopyAsyncData;
+
 typedef struct _GstWebVideoFrameAllocationSizeData
 {
   val video_frame;
   gsize ret;
 } GstWebVideoFrameAllocationSizeData;
 
+typedef struct _GstWebVideoFrameImportData
+{
+  GstWebVideoFrame *self;
+  GstWebRunner *runner;
+  /* Only plain values can cross from one runner to the other */
+  guint8 *data;
+  gsize size;
+  gchar *format;
+  gint coded_width;
+  gint coded_height;
+  gint display_width;
+  gint display_height;
+  gdouble timestamp;
+  guint n_planes;
+  guint offsets[GST_VIDEO_MAX_PLANES];
+  guint strides[GST_VIDEO_MAX_PLANES];
+  GstWebVideoFrame *ret;
+} GstWebVideoFrameImportData;
+
 static void
 gst_web_video_frame_allocation_size (gpointer data)
 {
@@ -121,6 +150,61 @@ GST_DEFINE_MINI_OBJECT_TYPE (GstWebVideoFrame, gst_web_video_frame);
 G_DEFINE_TYPE (GstWebVideoFrameAllocator, gst_web_video_frame_allocator,
     GST_TYPE_ALLOCATOR);
 
+/* The copyTo() options to copy @video_frame with the layout of @info */
+static gboolean
+gst_web_video_frame_copy_options (
+    val &video_frame, GstVideoInfo *info, val &options)
+{
+  const char *format;
+  val layout = val::array ();
+  guint i;
+
+  format =
+      gst_web_utils_video_format_to_web_format (GST_VIDEO_INFO_FORMAT (info));
+  if (format == NULL) {
+    GST_ERROR ("Format %s is not supported.",
+        GST_VIDEO_FORMAT_INFO_NAME (info->finfo));
+    return FALSE;
+  }
+
+  // Setting the output format for CopyTo makes the browser think
+  // you need a convertion even if the subsampling format is the same.
+  // So downloading I420 will make it fail saying it only converts to RGBA.
+  // Only set it when a conversion is really needed.
+  if (video_frame["format"].isNull () ||
+      video_frame["format"].as<std::string> () != format) {
+    gsize expected;
+
+    if (!GST_VIDEO_INFO_IS_RGB (info)) {
+      GST_DEBUG ("The browser can not convert to %s", format);
+      return FALSE;
+    }
+
+    options.set ("format", format);
+    options.set ("colorSpace", "srgb");
+    /* Browsers not knowing the format option ignore it, check the size
+     * of the converted frame to know if the conversion is supported */
+    expected = video_frame["visibleRect"]["width"].as<gsize> () *
+               video_frame["visibleRect"]["height"].as<gsize> () * 4;
+    if (video_frame.call<double> ("allocationSize", options) != expected) {
+      GST_DEBUG ("The browser can not convert to %s", format);
+      return FALSE;
+    }
+  }
+
+  /* Honour the strides and offsets of the GstVideoInfo */
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (info); i++) {
+    val plane = val::object ();
+
+    plane.set ("offset", (guint) GST_VIDEO_INFO_PLANE_OFFSET (info, i));
+    plane.set ("stride", GST_VIDEO_INFO_PLANE_STRIDE (info, i));
+    layout.call<void> ("push", plane);
+  }
+  options.set ("layout", layout);
+
+  return TRUE;
+}
+
 static gboolean
 gst_web_video_frame_map_internal (
     GstWebVideoFrame *self, GstVideoInfo *info, gpointer data, gsize size)
@@ -135,26 +219,12 @@ gst_web_video_frame_map_internal (
     val (typed_memory_view (size, (guint8 *)data));
   val options = val::object ();
 
-#if 0
-  // Setting the output format for CopyTo makes the browser think
-  // you need a convertion even if the subsampling format is the same.
-  // So downloading I420 will make it fail saying it only converts to RGBA.
-  // While not setting the format downloads I420 by copying just fine.
   if (info != NULL) {
-    const char *format;
-
-    format = gst_web_utils_video_format_to_web_format (
-        GST_VIDEO_FORMAT_INFO_FORMAT (info->finfo));
-    if (format == NULL) {
-      GST_ERROR ("Format %s is not supported.",
-          GST_VIDEO_FORMAT_INFO_NAME (info->finfo));
+    if (!gst_web_video_frame_copy_options (video_frame, info, options))
       return FALSE;
-    }
-    options.set ("format", format);
   } else {
     GST_DEBUG ("Use input format.");
   }
-#endif
 
   video_frame.call<val> ("copyTo", data_view, options).await ();
 
@@ -172,6 +242,20 @@ gst_web_video_frame_allocator_map_cpu_access (gpointer data)
       self, cdata->info, cdata->data, cdata->size);
 }
 
+/**
+ * gst_web_video_frame_copy_to:
+ * @self: a #GstWebVideoFrame
+ * @info: the #GstVideoInfo of @data
+ * @data: the destination
+ * @size: the size of @data
+ *
+ * Copies @self into @data with the layout of @info. When the format of @info
+ * is not the one of @self the browser converts it, only RGB formats are
+ * supported.
+ *
+ * Returns: %FALSE if the copy failed or the browser can not convert @self
+ * to the format of @info
+ */
 gboolean
 gst_web_video_frame_copy_to (
     GstWebVideoFrame *self, GstVideoInfo *info, guint8 *data, gsize size)
@@ -191,6 +275,91 @@ gst_web_video_frame_copy_to (
   return cdata.result;
 }
 
+static void
+gst_web_video_frame_on_copied (guintptr data, bool result)
+{
+  GstWebVideoFrameCopyAsyncData *cdata =
+      (GstWebVideoFrameCopyAsyncData *) data;
+
+  GST_LOG ("Video frame %p copied, result: %d", cdata->self, result);
+  cdata->func (result, cdata->user_data);
+  gst_memory_unref (GST_MEMORY_CAST (cdata->self));
+  g_free (cdata);
+}
+
+EMSCRIPTEN_BINDINGS (gst_web_video_frame)
+{
+  function ("gst_web_video_frame_on_copied", &gst_web_video_frame_on_copied);
+}
+
+/* Does not wait for copyTo(), several copies can be in flight on the same
+ * runner */
+static void
+gst_web_video_frame_copy_to_async_internal (gpointer data)
+{
+  GstWebVideoFrameCopyAsyncData *cdata =
+      (GstWebVideoFrameCopyAsyncData *) data;
+  val video_frame = gst_web_video_frame_get_handle (cdata->self);
+  val options = val::object ();
+  val promise;
+
+  if (!gst_web_video_frame_copy_options (video_frame, &cdata->info, options)) {
+    gst_web_video_frame_on_copied ((guintptr) cdata, false);
+    return;
+  }
+
+  promise = video_frame.call<val> ("copyTo",
+      val (typed_memory_view (cdata->size, cdata->data)), options);
+
+  /* clang-format off */
+  EM_ASM ({
+    const data = $0;
+    const promise = Emval.toValue ($1);
+
+    promise.then (() => {
+      Module.gst_web_video_frame_on_copied (data, true);
+    }, () => {
+      Module.gst_web_video_frame_on_copied (data, false);
+    });
+  }, (guintptr) cdata, promise.as_handle ());
+  /* clang-format on */
+}
+
+/**
+ * gst_web_video_frame_copy_to_async:
+ * @self: a #GstWebVideoFrame
+ * @info: the #GstVideoInfo of @data
+ * @data: the destination, it must stay valid until @func is called
+ * @size: the size of @data
+ * @func: called from the runner of @self once the copy is done
+ * @user_data: user data for @func
+ *
+ * Like gst_web_video_frame_copy_to() but without waiting for the copy to
+ * finish. @self is kept alive until then.
+ */
+void
+gst_web_video_frame_copy_to_async (GstWebVideoFrame *self, GstVideoInfo *info,
+    guint8 *data, gsize size, GstWebVideoFrameCopyFunc func,
+    gpointer user_data)
+{
+  GstWebVideoFrameCopyAsyncData *cdata;
+
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (func != NULL);
+
+  cdata = g_new0 (GstWebVideoFrameCopyAsyncData, 1);
+  cdata->self = (GstWebVideoFrame *) gst_memory_ref (GST_MEMORY_CAST (self));
+  cdata->info = *info;
+  cdata->data = data;
+  cdata->size = size;
+  cdata->func = func;
+  cdata->user_data = user_data;
+
+  gst_web_runner_send_message_async (self->priv->runner,
+      gst_web_video_frame_copy_to_async_internal, cdata, NULL);
+}
+
 static gpointer
 gst_web_video_frame_allocator_map_full (
     GstWebVideoFrame *self, GstMapInfo *info, gsize size)
@@ -373,3 +542,132 @@ gst_web_video_frame_get_handle (GstWebVideoFrame *self)
 {
   return self->priv->video_frame;
 }
+
+/**
+ * gst_web_video_frame_get_runner:
+ * @self: a #GstWebVideoFrame
+ *
+ * Returns: (transfer full): the #GstWebRunner the VideoFrame of @self
+ * belongs to
+ */
+GstWebRunner *
+gst_web_video_frame_get_runner (GstWebVideoFrame *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return (GstWebRunner *) gst_object_ref (self->priv->runner);
+}
+
+static void
+gst_web_video_frame_export_planes (gpointer data)
+{
+  GstWebVideoFrameImportData *import_data =
+      (GstWebVideoFrameImportData *) data;
+  val video_frame = import_data->self->priv->video_frame;
+  val layout;
+  guint i;
+
+  /* Frames without a format can not be copied */
+  if (video_frame["format"].isNull ())
+    return;
+
+  import_data->format =
+      g_strdup (video_frame["format"].as<std::string> ().c_str ());
+  import_data->coded_width = video_frame["codedWidth"].as<int> ();
+  import_data->coded_height = video_frame["codedHeight"].as<int> ();
+  import_data->display_width = video_frame["displayWidth"].as<int> ();
+  import_data->display_height = video_frame["displayHeight"].as<int> ();
+  import_data->timestamp = video_frame["timestamp"].as<double> ();
+  import_data->size = video_frame.call<int> ("allocationSize");
+  import_data->data = (guint8 *) g_malloc (import_data->size);
+
+  layout = video_frame
+               .call<val> ("copyTo",
+                   val (typed_memory_view (
+                       import_data->size, import_data->data)))
+               .await ();
+  import_data->n_planes =
+      MIN (layout["length"].as<guint> (), GST_VIDEO_MAX_PLANES);
+  for (i = 0; i < import_data->n_planes; i++) {
+    import_data->offsets[i] = layout[i]["offset"].as<guint> ();
+    import_data->strides[i] = layout[i]["stride"].as<guint> ();
+  }
+}
+
+static void
+gst_web_video_frame_import_planes (gpointer data)
+{
+  GstWebVideoFrameImportData *import_data =
+      (GstWebVideoFrameImportData *) data;
+  val init = val::object ();
+  val layout = val::array ();
+  val video_frame;
+  guint i;
+
+  init.set ("format", std::string (import_data->format));
+  init.set ("codedWidth", import_data->coded_width);
+  init.set ("codedHeight", import_data->coded_height);
+  init.set ("displayWidth", import_data->display_width);
+  init.set ("displayHeight", import_data->display_height);
+  init.set ("timestamp", import_data->timestamp);
+  for (i = 0; i < import_data->n_planes; i++) {
+    val plane = val::object ();
+
+    plane.set ("offset", import_data->offsets[i]);
+    plane.set ("stride", import_data->strides[i]);
+    layout.call<void> ("push", plane);
+  }
+  init.set ("layout", layout);
+
+  video_frame = val::global ("VideoFrame")
+                    .new_ (val (typed_memory_view (
+                               import_data->size, import_data->data)),
+                        init);
+  import_data->ret =
+      gst_web_video_frame_wrap (video_frame, import_data->runner);
+}
+
+/**
+ * gst_web_video_frame_import:
+ * @self: a #GstWebVideoFrame
+ * @runner: the #GstWebRunner the returned frame must belong to
+ *
+ * VideoFrames can not be shared among JS threads. When @self belongs to a
+ * different runner than @runner, its planes are copied to the wasm memory,
+ * which is shared, and a new VideoFrame is created from them on @runner.
+ *
+ * Returns: (transfer full) (nullable): a #GstWebVideoFrame usable from
+ * @runner, @self with a new reference if it already belongs to it
+ */
+GstWebVideoFrame *
+gst_web_video_frame_import (GstWebVideoFrame *self, GstWebRunner *runner)
+{
+  GstWebVideoFrameImportData import_data = {};
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (GST_IS_WEB_RUNNER (runner), NULL);
+
+  if (self->priv->runner == runner)
+    return (GstWebVideoFrame *) gst_memory_ref (GST_MEMORY_CAST (self));
+
+  GST_LOG ("Importing video frame %p from runner %" GST_PTR_FORMAT
+           " into runner %" GST_PTR_FORMAT,
+      self, self->priv->runner, runner);
+  import_data.self = self;
+  import_data.runner = runner;
+  gst_web_runner_send_message (
+      self->priv->runner, gst_web_video_frame_export_planes, &import_data);
+  if (!import_data.data) {
+    GST_ERROR ("Impossible to copy the video frame %p", self);
+    goto done;
+  }
+
+  gst_web_runner_send_message (
+      runner, gst_web_video_frame_import_planes, &import_data);
+
+done:
+  g_free (import_data.data);
+  g_free (import_data.format);
+
+  return import_data.ret;
+}
@@ -50,6 +50,15 @@ typedef struct _GstWebVideoFramePrivate GstWebVideoFramePrivate;
 typedef struct _GstWebVideoFrameAllocationParams
     GstWebVideoFrameAllocationParams;
 
+/**
+ * GstWebVideoFrameCopyFunc:
+ * @result: whether the copy succeeded
+ * @user_data: the user data
+ *
+ * Called once gst_web_video_frame_copy_to_async() is done
+ */
+typedef void (*GstWebVideoFrameCopyFunc) (gboolean result, gpointer user_data);
+
 struct _GstWebVideoFrame
 {
   GstMemory base;
@@ -84,6 +93,12 @@ void gst_web_video_frame_init (void);
 gboolean
 gst_web_video_frame_copy_to (
    GstWebVideoFrame *self, GstVideoInfo *info, guint8 *data, gsize size);
+void gst_web_video_frame_copy_to_async (GstWebVideoFrame *self,
+    GstVideoInfo *info, guint8 *data, gsize size,
+    GstWebVideoFrameCopyFunc func, gpointer user_data);
+GstWebVideoFrame *gst_web_video_frame_import (
+    GstWebVideoFrame *self, GstWebRunner *runner);
+GstWebRunner *gst_web_video_frame_get_runner (GstWebVideoFrame *self);
 
 G_END_DECLS
 
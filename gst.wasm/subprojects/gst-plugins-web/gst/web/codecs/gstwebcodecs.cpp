@@ -41,6 +41,7 @@
 #include <gst/gst.h>
 #include <gst/pbutils/pbutils.h>
 #include <emscripten/bind.h>
+#include <emscripten/threading.h>
 
 #include "gstwebcodecs.h"
 #include "gstwebcodecsvideodecoder.h"
@@ -56,6 +57,19 @@ GST_DEBUG_CATEGORY_STATIC (web_codecs_debug);
 static const gchar *accelerations[] = { "prefer-software", "prefer-hardware",
   NULL };
 
+/* Upper bound of the runner pool, whatever the amount of cores is */
+#define RUNNER_POOL_MAX_SIZE 8
+
+typedef struct _GstWebCodecsPooledRunner
+{
+  GstWebRunner *runner;
+  guint users;
+} GstWebCodecsPooledRunner;
+
+static GMutex runner_pool_lock;
+static GstWebCodecsPooledRunner *runner_pool = NULL;
+static guint runner_pool_size = 0;
+
 static gchar *
 create_type_name (const gchar *parent_name, const gchar *codec_name)
 {
@@ -206,6 +220,8 @@ scan_video_decoders (GstPlugin *plugin)
   gst_web_codecs_utils_scan_video_h264_decoder (plugin, vdecclass);
 }
 
+#include "utils/audio.cpp"
+
 static void
 scan_audio_decoders (GstPlugin *plugin)
 {
@@ -215,13 +231,139 @@ scan_audio_decoders (GstPlugin *plugin)
     return;
   }
 
-  GstCaps *caps;
+  gst_web_codecs_utils_scan_audio_decoders (plugin, adecclass);
+}
 
-  caps = gst_caps_from_string ("audio/mpeg, stream-format=raw");
-  // TODO: Support adts: https://www.w3.org/TR/webcodecs-aac-codec-registration/#aac-bitstream-format
-  // TODO: Check supported config and caps
-  register_audio_decoder (plugin, "AACSW", caps, FALSE);
-  gst_caps_unref (caps);
+GType
+gst_web_codecs_hardware_acceleration_get_type (void)
+{
+  static gsize type = 0;
+  static const GEnumValue values[] = {
+    { GST_WEB_CODECS_HARDWARE_ACCELERATION_NO_PREFERENCE,
+        "Let the browser decide", "no-preference" },
+    { GST_WEB_CODECS_HARDWARE_ACCELERATION_PREFER_HARDWARE,
+        "Prefer hardware decoding", "prefer-hardware" },
+    { GST_WEB_CODECS_HARDWARE_ACCELERATION_PREFER_SOFTWARE,
+        "Prefer software decoding", "prefer-software" },
+    { 0, NULL, NULL },
+  };
+
+  if (g_once_init_enter (&type)) {
+    GType _type = g_enum_register_static (
+        "GstWebCodecsHardwareAcceleration", values);
+    g_once_init_leave (&type, _type);
+  }
+  return type;
+}
+
+const gchar *
+gst_web_codecs_hardware_acceleration_to_string (
+    GstWebCodecsHardwareAcceleration acceleration)
+{
+  GEnumClass *klass;
+  GEnumValue *value;
+  const gchar *ret = NULL;
+
+  klass = (GEnumClass *) g_type_class_ref (
+      GST_TYPE_WEB_CODECS_HARDWARE_ACCELERATION);
+  value = g_enum_get_value (klass, acceleration);
+  if (value)
+    ret = value->value_nick;
+  g_type_class_unref (klass);
+
+  return ret;
+}
+
+GType
+gst_web_codecs_runner_mode_get_type (void)
+{
+  static gsize type = 0;
+  static const GEnumValue values[] = {
+    { GST_WEB_CODECS_RUNNER_MODE_SHARED, "Use the runner of the canvas",
+        "shared" },
+    { GST_WEB_CODECS_RUNNER_MODE_DEDICATED, "Use a runner per decoder",
+        "dedicated" },
+    { GST_WEB_CODECS_RUNNER_MODE_POOL, "Use a runner from a bounded pool",
+        "pool" },
+    { GST_WEB_CODECS_RUNNER_MODE_AUTO,
+        "Use the pool when copying to system memory, the shared one "
+        "otherwise",
+        "auto" },
+    { 0, NULL, NULL },
+  };
+
+  if (g_once_init_enter (&type)) {
+    GType _type = g_enum_register_static ("GstWebCodecsRunnerMode", values);
+    g_once_init_leave (&type, _type);
+  }
+  return type;
+}
+
+/**
+ * gst_web_codecs_runner_pool_acquire:
+ *
+ * Gets the least used runner of the pool, creating it if needed. The pool
+ * has one runner per core, minus the one of the main thread.
+ *
+ * Returns: (transfer full): a runner, release it with
+ * gst_web_codecs_runner_pool_release()
+ */
+GstWebRunner *
+gst_web_codecs_runner_pool_acquire (void)
+{
+  GstWebCodecsPooledRunner *pooled;
+  guint i;
+
+  g_mutex_lock (&runner_pool_lock);
+  if (!runner_pool) {
+    runner_pool_size = CLAMP (
+        emscripten_num_logical_cores () - 1, 1, RUNNER_POOL_MAX_SIZE);
+    runner_pool = g_new0 (GstWebCodecsPooledRunner, runner_pool_size);
+    GST_INFO ("Runner pool of %u runners", runner_pool_size);
+  }
+
+  pooled = &runner_pool[0];
+  for (i = 1; i < runner_pool_size; i++) {
+    if (runner_pool[i].users < pooled->users)
+      pooled = &runner_pool[i];
+  }
+  if (!pooled->runner)
+    pooled->runner = gst_web_runner_new (NULL);
+  pooled->users++;
+  GST_DEBUG ("Acquired runner %" GST_PTR_FORMAT " used by %u decoders",
+      pooled->runner, pooled->users);
+  g_mutex_unlock (&runner_pool_lock);
+
+  return (GstWebRunner *) gst_object_ref (pooled->runner);
+}
+
+/**
+ * gst_web_codecs_runner_pool_release:
+ * @runner: (transfer full): a runner from gst_web_codecs_runner_pool_acquire()
+ *
+ * The runner is destroyed once no decoder uses it and the frames it owns
+ * are gone
+ */
+void
+gst_web_codecs_runner_pool_release (GstWebRunner *runner)
+{
+  guint i;
+
+  g_mutex_lock (&runner_pool_lock);
+  for (i = 0; i < runner_pool_size; i++) {
+    GstWebCodecsPooledRunner *pooled = &runner_pool[i];
+
+    if (pooled->runner != runner)
+      continue;
+
+    pooled->users--;
+    if (!pooled->users)
+      g_clear_pointer (&pooled->runner, gst_object_unref);
+    break;
+  }
+  g_mutex_unlock (&runner_pool_lock);
+
+  gst_object_unref (runner);
 }
 
 gboolean
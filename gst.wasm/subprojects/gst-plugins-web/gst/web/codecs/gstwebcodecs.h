@@ -24,9 +24,55 @@
 #define __GST_WEB_CODECS_H__
 
 #include <gst/gst.h>
+#include <gst/web/gstwebrunner.h>
 
 G_BEGIN_DECLS
 
+/**
+ * GstWebCodecsHardwareAcceleration:
+ *
+ * Maps to the WebCodecs HardwareAcceleration enum, the nick of each value is
+ * the string expected by the decoders configure()
+ */
+typedef enum _GstWebCodecsHardwareAcceleration
+{
+  GST_WEB_CODECS_HARDWARE_ACCELERATION_NO_PREFERENCE,
+  GST_WEB_CODECS_HARDWARE_ACCELERATION_PREFER_HARDWARE,
+  GST_WEB_CODECS_HARDWARE_ACCELERATION_PREFER_SOFTWARE,
+} GstWebCodecsHardwareAcceleration;
+
+#define GST_TYPE_WEB_CODECS_HARDWARE_ACCELERATION                             \
+  (gst_web_codecs_hardware_acceleration_get_type ())
+
+GType gst_web_codecs_hardware_acceleration_get_type (void);
+const gchar *gst_web_codecs_hardware_acceleration_to_string (
+    GstWebCodecsHardwareAcceleration acceleration);
+
+/**
+ * GstWebCodecsRunnerMode:
+ *
+ * Where a decoder runs its WebCodecs calls. The shared runner is the one of
+ * the #GstWebCanvas, the same the sink uses. A dedicated runner is a new
+ * thread per decoder and the pool bounds the amount of threads created for
+ * the decoders to the available cores. VideoFrames can not be shared among
+ * runners, the ones consumed on another runner are copied, so auto uses
+ * the shared runner unless the frames are copied to system memory
+ */
+typedef enum _GstWebCodecsRunnerMode
+{
+  GST_WEB_CODECS_RUNNER_MODE_SHARED,
+  GST_WEB_CODECS_RUNNER_MODE_DEDICATED,
+  GST_WEB_CODECS_RUNNER_MODE_POOL,
+  GST_WEB_CODECS_RUNNER_MODE_AUTO,
+} GstWebCodecsRunnerMode;
+
+#define GST_TYPE_WEB_CODECS_RUNNER_MODE                                       \
+  (gst_web_codecs_runner_mode_get_type ())
+
+GType gst_web_codecs_runner_mode_get_type (void);
+GstWebRunner *gst_web_codecs_runner_pool_acquire (void);
+void gst_web_codecs_runner_pool_release (GstWebRunner *runner);
+
 gboolean gst_web_codecs_init (GstPlugin *plugin);
 
 extern GQuark gst_web_codecs_data_quark;
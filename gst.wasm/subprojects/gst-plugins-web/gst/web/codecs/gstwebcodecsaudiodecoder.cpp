@@ -55,12 +55,24 @@
 using namespace emscripten;
 
 #define GST_WEB_CODECS_AUDIO_DECODER_MAX_DEQUEUE 32
+/* Errors in a row, without any output in between, before giving up */
+#define GST_WEB_CODECS_AUDIO_DECODER_MAX_RECOVERIES 3
+
+#define DEFAULT_STATS_INTERVAL 0
 
 #define GST_CAT_DEFAULT gst_web_codecs_audio_decoder_debug_category
 GST_DEBUG_CATEGORY_STATIC (gst_web_codecs_audio_decoder_debug_category);
 
 static gpointer parent_class = NULL;
 
+enum
+{
+  PROP_0,
+  PROP_STATS,
+  PROP_STATS_INTERVAL,
+  PROP_LAST
+};
+
 typedef struct _GstWebCodecsAudioDecoderConfigureData
 {
   GstWebCodecsAudioDecoder *self;
@@ -74,33 +86,15 @@ typedef struct _GstWebCodecsAudioDecoderDecodeData
   GstBuffer *buffer;
 } GstWebCodecsAudioDecoderDecodeData;
 
+static void gst_web_codecs_audio_decoder_ctor (gpointer data);
+static void gst_web_codecs_audio_decoder_configure (gpointer data);
+
 static bool
 is_audio_format_planar (const std::string &format)
 {
   return format.find ("-planar") != std::string::npos;
 }
 
-static inline guint32
-get_total_allocation_size (val audio_data, int channels, bool planar)
-{
-  guint32 total_size = 0;
-
-  if (planar) {
-    for (int i = 0; i < channels; ++i) {
-      val opts = val::object ();
-      opts.set ("planeIndex", i);
-      total_size +=
-          audio_data.call<val> ("allocationSize", opts).as<guint32> ();
-    }
-  } else {
-    val opts = val::object ();
-    opts.set ("planeIndex", 0);
-    total_size = audio_data.call<val> ("allocationSize", opts).as<guint32> ();
-  }
-
-  return total_size;
-}
-
 static GstAudioChannelPosition *
 gst_web_codecs_audio_guess_channel_positions (gint channels)
 {
@@ -132,6 +126,100 @@ gst_web_codecs_audio_guess_channel_positions (gint channels)
   return positions;
 }
 
+static void
+gst_web_codecs_audio_decoder_clear_pool (GstWebCodecsAudioDecoder *self)
+{
+  if (!self->pool)
+    return;
+
+  gst_buffer_pool_set_active (self->pool, FALSE);
+  gst_clear_object (&self->pool);
+  self->pool_size = 0;
+}
+
+/* The most samples per channel a frame of the codec decodes to at @rate,
+ * 0 when it depends on the stream
+ */
+static guint
+gst_web_codecs_audio_decoder_get_max_spf (GstCaps *caps, gint rate)
+{
+  GstStructure *s = gst_caps_get_structure (caps, 0);
+  gint mpegversion = 0;
+  gint layer = 3;
+
+  if (gst_structure_has_name (s, "audio/x-opus"))
+    return rate * 120 / 1000;
+  else if (gst_structure_has_name (s, "audio/x-vorbis"))
+    return 4096;
+  else if (!gst_structure_has_name (s, "audio/mpeg"))
+    return 0;
+
+  gst_structure_get_int (s, "mpegversion", &mpegversion);
+  if (mpegversion != 1)
+    return 2048; /* HE-AAC doubles the 1024 samples of the core */
+  gst_structure_get_int (s, "layer", &layer);
+
+  return layer == 1 ? 384 : 1152;
+}
+
+/* Called with the streaming lock taken, once the output format is known.
+ * @frames is the size of the first AudioData, used when the codec does not
+ * tell the size of its frames
+ */
+static gboolean
+gst_web_codecs_audio_decoder_setup_pool (
+    GstWebCodecsAudioDecoder *self, guint frames)
+{
+  GstStructure *config;
+  GstCaps *caps;
+  guint spf;
+
+  spf = gst_web_codecs_audio_decoder_get_max_spf (
+      self->input_caps, GST_AUDIO_INFO_RATE (&self->output_info));
+  self->pool_size =
+      MAX (spf, frames) * GST_AUDIO_INFO_BPF (&self->output_info);
+
+  gst_web_codecs_audio_decoder_clear_pool (self);
+  self->pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (self->pool);
+  caps = gst_audio_info_to_caps (&self->output_info);
+  gst_buffer_pool_config_set_params (config, caps, self->pool_size, 0, 0);
+  gst_caps_unref (caps);
+  if (!gst_buffer_pool_set_config (self->pool, config) ||
+      !gst_buffer_pool_set_active (self->pool, TRUE)) {
+    GST_ERROR_OBJECT (self, "Impossible to configure the pool");
+    gst_clear_object (&self->pool);
+    return FALSE;
+  }
+  GST_DEBUG_OBJECT (self, "Pool of %" G_GSIZE_FORMAT " bytes buffers",
+      self->pool_size);
+
+  return TRUE;
+}
+
+/* Called with the streaming lock taken. An AudioData bigger than the pool
+ * buffers gets a buffer of its own
+ */
+static GstBuffer *
+gst_web_codecs_audio_decoder_acquire_buffer (
+    GstWebCodecsAudioDecoder *self, gsize size)
+{
+  GstBuffer *buffer = NULL;
+
+  if (size > self->pool_size) {
+    GST_WARNING_OBJECT (self,
+        "AudioData of %" G_GSIZE_FORMAT " bytes does not fit the pool", size);
+    return gst_buffer_new_allocate (NULL, size, NULL);
+  }
+
+  if (gst_buffer_pool_acquire_buffer (self->pool, &buffer, NULL) !=
+      GST_FLOW_OK)
+    return NULL;
+  gst_buffer_resize (buffer, 0, size);
+
+  return buffer;
+}
+
 static gboolean
 gst_web_codecs_audio_decoder_get_format (
     GstWebCodecsAudioDecoder *self, val audio_data)
@@ -182,8 +270,31 @@ gst_web_codecs_audio_decoder_get_format (
       number_of_channels, positions);
   g_free (positions);
 
-  self->output_info.layout =
-      planar ? GST_AUDIO_LAYOUT_NON_INTERLEAVED : GST_AUDIO_LAYOUT_INTERLEAVED;
+  /* copyTo() can interleave the planes, most elements only handle
+   * interleaved audio
+   */
+  g_free (self->copy_format);
+  self->copy_format = g_strdup (format_str);
+  if (planar) {
+    GstCaps *peer_caps;
+    GstCaps *caps;
+
+    self->output_info.layout = GST_AUDIO_LAYOUT_INTERLEAVED;
+    caps = gst_audio_info_to_caps (&self->output_info);
+    peer_caps =
+        gst_pad_peer_query_caps (GST_AUDIO_DECODER_SRC_PAD (self), NULL);
+    if (gst_caps_can_intersect (caps, peer_caps)) {
+      self->copy_format[strlen (format_str) - strlen ("-planar")] = '\0';
+      planar = FALSE;
+    } else {
+      self->output_info.layout = GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+    }
+    gst_caps_unref (peer_caps);
+    gst_caps_unref (caps);
+  } else {
+    self->output_info.layout = GST_AUDIO_LAYOUT_INTERLEAVED;
+  }
+  GST_DEBUG_OBJECT (self, "Copying AudioData as %s", self->copy_format);
 
   // Log the audio info values
   GST_DEBUG_OBJECT (self,
@@ -206,53 +317,172 @@ gst_web_codecs_audio_decoder_get_format (
 
   GST_DEBUG_OBJECT (self, "Output caps: %" GST_PTR_FORMAT, self->output_caps);
 
+  if (!gst_web_codecs_audio_decoder_setup_pool (
+          self, audio_data["numberOfFrames"].as<int> ()))
+    return FALSE;
+
   return gst_audio_decoder_negotiate (GST_AUDIO_DECODER (self));
 }
 
-static void
+/* Copies the plane @index of @audio_data into @data, converted to @format.
+ * FALSE when the browser throws NotSupportedError for the conversion, any
+ * other error is thrown as is
+ */
+static gboolean
+gst_web_codecs_audio_decoder_copy_to (val audio_data, guint index,
+    const gchar *format, guint8 *data, gsize size)
+{
+  val dest = val (typed_memory_view (size, data));
+  val opts = val::object ();
+
+  opts.set ("format", std::string (format));
+  opts.set ("planeIndex", index);
+  /* clang-format off */
+  return EM_ASM_INT ({
+    const audioData = Emval.toValue ($0);
+
+    try {
+      audioData.copyTo (Emval.toValue ($1), Emval.toValue ($2));
+    } catch (e) {
+      if (e.name == "NotSupportedError")
+        return 0;
+      throw e;
+    }
+    return 1;
+  }, audio_data.as_handle (), dest.as_handle (), opts.as_handle ());
+  /* clang-format on */
+}
+
+/* Copies every plane of the planar @audio_data as is, interleaving them
+ * into @data. FALSE when the browser can not copy a plane
+ */
+static gboolean
+gst_web_codecs_audio_decoder_interleave (GstWebCodecsAudioDecoder *self,
+    val audio_data, guint8 *data, guint frames)
+{
+  GstAudioInfo *info = &self->output_info;
+  std::string format = audio_data["format"].as<std::string> ();
+  gint channels = GST_AUDIO_INFO_CHANNELS (info);
+  gint bps = GST_AUDIO_INFO_BPS (info);
+  gsize plane_size = frames * bps;
+  guint8 *planes;
+  guint i;
+  gint c;
+
+  planes = (guint8 *) g_malloc (plane_size * channels);
+  for (c = 0; c < channels; c++) {
+    if (!gst_web_codecs_audio_decoder_copy_to (audio_data, c, format.c_str (),
+            planes + c * plane_size, plane_size)) {
+      GST_ERROR_OBJECT (self, "copyTo() can not copy the plane %d as %s", c,
+          format.c_str ());
+      g_free (planes);
+      return FALSE;
+    }
+  }
+  for (i = 0; i < frames; i++) {
+    for (c = 0; c < channels; c++) {
+      memcpy (data + (i * channels + c) * bps,
+          planes + c * plane_size + i * bps, bps);
+    }
+  }
+  g_free (planes);
+
+  return TRUE;
+}
+
+/* Copies the AudioData with one copyTo() per plane, a single one when
+ * interleaved. The plane sizes come from the negotiated format, no need to
+ * ask for the allocationSize()
+ */
+static gboolean
 gst_web_codecs_audio_decoder_audio_data_to_buffer (
     GstWebCodecsAudioDecoder *self, val audio_data, GstBuffer *buffer,
-    guint32 total_size)
+    guint frames)
 {
+  GstAudioInfo *info = &self->output_info;
   GstMapInfo map;
-  int channels = audio_data["numberOfChannels"].as<int> ();
-  std::string format = audio_data["format"].as<std::string> ();
-  bool planar = is_audio_format_planar (format);
+  gsize plane_size;
+  guint n_planes;
+  guint i;
+  val opts = val::object ();
 
   if (!gst_buffer_map (buffer, &map, GST_MAP_WRITE)) {
     GST_ERROR_OBJECT (self, "Failed to map buffer");
-    return;
+    return FALSE;
   }
 
-  g_assert (map.size == total_size);
-
-  GST_DEBUG_OBJECT (self, "Copy AudioData to GstBuffer");
-  if (planar) {
-    guint8 *dst_ptr = map.data;
-    for (int i = 0; i < channels; i++) {
-      val opts = val::object ();
-      opts.set ("planeIndex", i);
-      guint32 plane_size =
-          audio_data.call<val> ("allocationSize", opts).as<guint32> ();
-
-      val dst_view = val (typed_memory_view (plane_size, dst_ptr));
-      audio_data.call<val> ("copyTo", dst_view, opts);
-      dst_ptr += plane_size;
+  /* copyTo() interleaves the planes when the browser supports it */
+  if (info->layout == GST_AUDIO_LAYOUT_INTERLEAVED &&
+      is_audio_format_planar (audio_data["format"].as<std::string> ())) {
+    if (!self->copy_per_plane &&
+        !gst_web_codecs_audio_decoder_copy_to (audio_data, 0,
+            self->copy_format, map.data,
+            frames * GST_AUDIO_INFO_BPF (info))) {
+      GST_INFO_OBJECT (self, "copyTo() can not convert to %s, interleaving "
+          "the planes instead", self->copy_format);
+      self->copy_per_plane = TRUE;
     }
-  } else {
-    GST_DEBUG_OBJECT (self, "Copy fisrt plane");
+    if (self->copy_per_plane &&
+        !gst_web_codecs_audio_decoder_interleave (
+            self, audio_data, map.data, frames)) {
+      gst_buffer_unmap (buffer, &map);
+      return FALSE;
+    }
+    gst_buffer_unmap (buffer, &map);
+    return TRUE;
+  }
 
-    val opts = val::object ();
-    opts.set ("planeIndex", 0);
-    guint32 plane_size =
-        audio_data.call<val> ("allocationSize", opts).as<guint32> ();
-    g_assert (total_size == plane_size);
-    val dst_view = val (typed_memory_view (total_size, map.data));
-    audio_data.call<val> ("copyTo", dst_view, opts);
+  if (info->layout == GST_AUDIO_LAYOUT_INTERLEAVED) {
+    n_planes = 1;
+    plane_size = frames * GST_AUDIO_INFO_BPF (info);
+  } else {
+    n_planes = GST_AUDIO_INFO_CHANNELS (info);
+    plane_size = frames * GST_AUDIO_INFO_BPS (info);
   }
 
+  GST_LOG_OBJECT (self, "Copying %u planes of %" G_GSIZE_FORMAT " bytes",
+      n_planes, plane_size);
+  opts.set ("format", std::string (self->copy_format));
+  for (i = 0; i < n_planes; i++) {
+    opts.set ("planeIndex", i);
+    audio_data.call<void> ("copyTo",
+        val (typed_memory_view (plane_size, map.data + i * plane_size)),
+        opts);
+  }
   gst_buffer_unmap (buffer, &map);
-  GST_DEBUG_OBJECT (self, "Copied AudioData to GstBuffer");
+
+  return TRUE;
+}
+
+static GstStructure *
+gst_web_codecs_audio_decoder_create_stats (GstWebCodecsAudioDecoder *self)
+{
+  GstStructure *stats;
+
+  stats = gst_structure_new_empty (
+      "application/x-webcodecs-audio-decoder-stats");
+  gst_web_codecs_stats_fill (&self->stats, stats);
+
+  return stats;
+}
+
+static void
+gst_web_codecs_audio_decoder_post_stats (GstWebCodecsAudioDecoder *self)
+{
+  GstStructure *stats;
+  guint interval;
+
+  GST_OBJECT_LOCK (self);
+  interval = self->stats_interval;
+  GST_OBJECT_UNLOCK (self);
+
+  if (!gst_web_codecs_stats_should_post (&self->stats, interval))
+    return;
+
+  stats = gst_web_codecs_audio_decoder_create_stats (self);
+  gst_structure_set_name (stats, "webcodecs-stats");
+  gst_element_post_message (GST_ELEMENT (self),
+      gst_message_new_element (GST_OBJECT (self), stats));
 }
 
 static void
@@ -262,26 +492,20 @@ gst_web_codecs_audio_decoder_on_output (guintptr self_, val audio_data)
   GstAudioDecoder *dec = GST_AUDIO_DECODER (self);
   GstBuffer *buffer = nullptr;
   GstFlowReturn flow;
+  gint frames;
 
   GST_INFO_OBJECT (self, "AudioFrame received");
-
-  // Estimate buffer size
-  guint total_size = 0;
-  int channels = audio_data["numberOfChannels"].as<int> ();
-  int frames = audio_data["numberOfFrames"].as<int> ();
-  std::string format = audio_data["format"].as<std::string> ();
-  bool planar = is_audio_format_planar (format);
-
-  GST_DEBUG_OBJECT (
-      self, "AudioData shape: channels=%d, frames=%d", channels, frames);
-  if (channels <= 0 || frames <= 0) {
-    GST_ERROR_OBJECT (self,
-        "AudioData has invalid shape: channels=%d, frames=%d", channels,
-        frames);
+  gst_web_codecs_stats_output (
+      &self->stats, (gint64) audio_data["timestamp"].as<double> ());
+
+  frames = audio_data["numberOfFrames"].as<int> ();
+  GST_DEBUG_OBJECT (self, "AudioData with %d frames", frames);
+  if (frames <= 0) {
+    GST_ERROR_OBJECT (self, "AudioData has no frames");
+    audio_data.call<void> ("close");
     return;
   }
 
-  // Lock the audio stream
   GST_AUDIO_DECODER_STREAM_LOCK (self);
 
   /* Configure the output */
@@ -293,39 +517,84 @@ gst_web_codecs_audio_decoder_on_output (guintptr self_, val audio_data)
     }
   }
 
-  total_size = get_total_allocation_size (audio_data, channels, planar);
-  GST_DEBUG_OBJECT (self, "Total size is %d", total_size);
-  if (total_size == 0) {
-    GST_ERROR_OBJECT (self, "Total size is 0");
-    goto done;
-  }
-
-  buffer = gst_audio_decoder_allocate_output_buffer (dec, total_size);
-  gst_buffer_add_audio_meta (
-      buffer, &self->output_info, (total_size / self->output_info.bpf), NULL);
+  buffer = gst_web_codecs_audio_decoder_acquire_buffer (
+      self, frames * GST_AUDIO_INFO_BPF (&self->output_info));
   if (!buffer) {
     GST_ERROR_OBJECT (self, "Failed to allocate output buffer");
     goto done;
   }
+  if (self->output_info.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+    gst_buffer_add_audio_meta (buffer, &self->output_info, frames, NULL);
 
-  gst_web_codecs_audio_decoder_audio_data_to_buffer (
-      self, audio_data, buffer, total_size);
+  if (!gst_web_codecs_audio_decoder_audio_data_to_buffer (
+          self, audio_data, buffer, frames)) {
+    gst_buffer_unref (buffer);
+    self->failed = TRUE;
+    GST_ELEMENT_ERROR (self, STREAM, DECODE, (NULL),
+        ("Impossible to copy the AudioData"));
+    goto done;
+  }
 
+  self->recoveries = 0;
   flow = gst_audio_decoder_finish_frame (dec, buffer, 1);
   if (flow != GST_FLOW_OK) {
     GST_WARNING_OBJECT (
         self, "Failed to finish frame: %s", gst_flow_get_name (flow));
-    gst_buffer_unref (buffer);
   }
 
 done:
   GST_AUDIO_DECODER_STREAM_UNLOCK (self);
+  audio_data.call<void> ("close");
+
+  gst_web_codecs_audio_decoder_post_stats (self);
 }
 
 static void
 gst_web_codecs_audio_decoder_on_error (guintptr self_, val error)
 {
-  GST_ERROR ("Error: %s", error.call<std::string> ("toString").c_str ());
+  GstWebCodecsAudioDecoder *self = (GstWebCodecsAudioDecoder *) self_;
+  GstWebCodecsAudioDecoderConfigureData conf_data;
+  std::string reason = error["message"].as<std::string> ();
+
+  GST_WARNING_OBJECT (self, "Error received: %s", reason.c_str ());
+  gst_web_codecs_stats_error (&self->stats);
+
+  GST_AUDIO_DECODER_STREAM_LOCK (self);
+  /* The browser closes the decoder on error, whatever was submitted is
+   * lost. Every audio chunk is a key one, a new decoder configured like
+   * the previous one can go on with the next chunk */
+  if (self->failed || !self->input_caps ||
+      self->recoveries >= GST_WEB_CODECS_AUDIO_DECODER_MAX_RECOVERIES) {
+    self->failed = TRUE;
+    GST_ELEMENT_ERROR (self, STREAM, DECODE, (NULL),
+        ("Decoder failed: %s", reason.c_str ()));
+  } else {
+    /* We are already on the runner */
+    self->recoveries++;
+    gst_web_codecs_audio_decoder_ctor (self);
+    conf_data.self = self;
+    conf_data.caps = self->input_caps;
+    gst_web_codecs_audio_decoder_configure (&conf_data);
+    if (!conf_data.ret) {
+      self->failed = TRUE;
+      GST_ELEMENT_ERROR (self, STREAM, DECODE, (NULL),
+          ("Impossible to reconfigure the decoder after: %s",
+              reason.c_str ()));
+    } else {
+      gst_element_post_message (GST_ELEMENT (self),
+          gst_message_new_element (GST_OBJECT (self),
+              gst_structure_new ("webcodecs-recovery", "reason",
+                  G_TYPE_STRING, reason.c_str (), "recoveries", G_TYPE_UINT,
+                  self->recoveries, NULL)));
+    }
+  }
+  GST_AUDIO_DECODER_STREAM_UNLOCK (self);
+
+  /* Unblock a handle_frame() waiting for a dequeue */
+  g_mutex_lock (&self->dequeue_lock);
+  self->dequeue_size = 0;
+  g_cond_signal (&self->dequeue_cond);
+  g_mutex_unlock (&self->dequeue_lock);
 }
 
 static void
@@ -335,6 +604,7 @@ gst_web_codecs_audio_decoder_on_dequeue (guintptr self_, val event)
   gint dequeue_size;
 
   dequeue_size = self->decoder["decodeQueueSize"].as<int> ();
+  gst_web_codecs_stats_dequeue (&self->stats, dequeue_size);
 
   GST_INFO_OBJECT (
       self, "Dequeue received with current size %d", dequeue_size);
@@ -400,12 +670,129 @@ gst_web_codecs_audio_decoder_decode (gpointer data)
 
   val chunk = chunkclass.new_ (options);
 
+  gst_web_codecs_stats_submit (&self->stats,
+      GST_BUFFER_PTS_IS_VALID (buf)
+          ? GST_TIME_AS_MSECONDS (GST_BUFFER_PTS (buf))
+          : -1);
   self->decoder.call<void> ("decode", chunk);
   gst_buffer_unmap (buf, &map);
 
   GST_DEBUG_OBJECT (self, "Done decoding");
 }
 
+/* The codec strings of the WebCodecs registry, only AAC needs the codec
+ * data to tell the profile
+ */
+static gchar *
+gst_web_codecs_audio_decoder_get_codec (GstCaps *caps)
+{
+  GstStructure *s = gst_caps_get_structure (caps, 0);
+  gint mpegversion = 0;
+
+  if (gst_structure_has_name (s, "audio/x-opus"))
+    return g_strdup ("opus");
+  else if (gst_structure_has_name (s, "audio/x-flac"))
+    return g_strdup ("flac");
+  else if (gst_structure_has_name (s, "audio/x-vorbis"))
+    return g_strdup ("vorbis");
+  else if (gst_structure_has_name (s, "audio/x-alaw"))
+    return g_strdup ("alaw");
+  else if (gst_structure_has_name (s, "audio/x-mulaw"))
+    return g_strdup ("ulaw");
+
+  gst_structure_get_int (s, "mpegversion", &mpegversion);
+  if (mpegversion == 1)
+    return g_strdup ("mp3");
+  /* The ADTS header has the profile, any AAC codec string is fine */
+  if (!gst_structure_has_field (s, "codec_data"))
+    return g_strdup ("mp4a.40.2");
+
+  return gst_codec_utils_caps_get_mime_codec (caps);
+}
+
+static GstBuffer *
+gst_web_codecs_audio_decoder_get_streamheader (GstStructure *s, guint n)
+{
+  const GValue *streamheader = gst_structure_get_value (s, "streamheader");
+
+  if (!streamheader || !GST_VALUE_HOLDS_ARRAY (streamheader) ||
+      gst_value_array_get_size (streamheader) <= n)
+    return NULL;
+
+  return gst_value_get_buffer (gst_value_array_get_value (streamheader, n));
+}
+
+/* The description expected by each codec registration. Without one AAC is
+ * ADTS and Opus uses the default channel mapping
+ */
+static GstBuffer *
+gst_web_codecs_audio_decoder_get_description (GstCaps *caps)
+{
+  GstStructure *s = gst_caps_get_structure (caps, 0);
+  const GValue *codec_data = gst_structure_get_value (s, "codec_data");
+  GstBuffer *header;
+  GstBuffer *ret;
+  GstMapInfo map;
+  guint8 lacing[1 + 2 * (G_MAXUINT16 / 255 + 1)];
+  gsize size, total;
+  guint i, n = 0;
+
+  if (gst_structure_has_name (s, "audio/mpeg"))
+    return codec_data ? gst_buffer_ref (gst_value_get_buffer (codec_data))
+                      : NULL;
+
+  header = gst_web_codecs_audio_decoder_get_streamheader (s, 0);
+  if (!header)
+    return NULL;
+
+  /* OpusHead */
+  if (gst_structure_has_name (s, "audio/x-opus"))
+    return gst_buffer_ref (header);
+
+  /* The first header is the Ogg FLAC mapping one, followed by the fLaC
+   * marker and the STREAMINFO block
+   */
+  if (gst_structure_has_name (s, "audio/x-flac")) {
+    if (gst_buffer_get_size (header) <= 9)
+      return NULL;
+    return gst_buffer_copy_region (
+        header, GST_BUFFER_COPY_MEMORY, 9, gst_buffer_get_size (header) - 9);
+  }
+
+  /* The three headers, Xiph laced */
+  if (gst_structure_has_name (s, "audio/x-vorbis")) {
+    GstBuffer *headers[3];
+
+    lacing[n++] = 2;
+    total = 0;
+    for (i = 0; i < 3; i++) {
+      headers[i] = gst_web_codecs_audio_decoder_get_streamheader (s, i);
+      if (!headers[i])
+        return NULL;
+      total += gst_buffer_get_size (headers[i]);
+      if (i == 2)
+        break;
+      if (gst_buffer_get_size (headers[i]) > G_MAXUINT16)
+        return NULL;
+      for (size = gst_buffer_get_size (headers[i]); size >= 255; size -= 255)
+        lacing[n++] = 255;
+      lacing[n++] = size;
+    }
+
+    ret = gst_buffer_new_allocate (NULL, n + total, NULL);
+    gst_buffer_fill (ret, 0, lacing, n);
+    for (i = 0; i < 3; i++) {
+      gst_buffer_map (headers[i], &map, GST_MAP_READ);
+      gst_buffer_fill (ret, n, map.data, map.size);
+      n += map.size;
+      gst_buffer_unmap (headers[i], &map);
+    }
+    return ret;
+  }
+
+  return NULL;
+}
+
 static void
 gst_web_codecs_audio_decoder_configure (gpointer data)
 {
@@ -413,58 +800,72 @@ gst_web_codecs_audio_decoder_configure (gpointer data)
       (GstWebCodecsAudioDecoderConfigureData *) data;
   GstWebCodecsAudioDecoder *self = conf_data->self;
   GstStructure *s;
-  const GValue *codec_data_value = NULL;
-  GstBuffer *codec_data = NULL;
+  GstBuffer *description;
   GstMapInfo map;
   gchar *mime_codec;
   gint channels, rate;
   val config = val::object ();
 
-  mime_codec = gst_codec_utils_caps_get_mime_codec (conf_data->caps);
-  config.set ("codec", std::string (mime_codec));
-  g_free (mime_codec);
-
+  conf_data->ret = FALSE;
   s = gst_caps_get_structure (conf_data->caps, 0);
   if (!gst_structure_get_int (s, "channels", &channels)) {
     GST_ERROR_OBJECT (self, "Caps do not have channels");
-    conf_data->ret = FALSE;
     return;
   }
 
-  s = gst_caps_get_structure (conf_data->caps, 0);
   if (!gst_structure_get_int (s, "rate", &rate)) {
     GST_ERROR_OBJECT (self, "Caps do not have rate");
-    conf_data->ret = FALSE;
-    return;
-  }
-  codec_data_value = gst_structure_get_value (s, "codec_data");
-  if (!codec_data_value) {
-    GST_ERROR_OBJECT (self, "Caps do not have codec_data");
-    conf_data->ret = FALSE;
     return;
   }
 
-  codec_data = gst_value_get_buffer (codec_data_value);
-  if (!gst_buffer_map (codec_data, &map, GST_MAP_READ)) {
-    GST_ERROR_OBJECT (self, "Impossible to map the buffer");
-    conf_data->ret = FALSE;
+  mime_codec = gst_web_codecs_audio_decoder_get_codec (conf_data->caps);
+  if (!mime_codec) {
+    GST_ERROR_OBJECT (self, "Impossible to get the codec string");
     return;
   }
-
-  val codec_data_js = val (typed_memory_view (map.size, map.data));
-  config.set ("description", codec_data_js);
+  config.set ("codec", std::string (mime_codec));
+  g_free (mime_codec);
   config.set ("numberOfChannels", channels);
   config.set ("sampleRate", rate);
 
+  description = gst_web_codecs_audio_decoder_get_description (conf_data->caps);
+  if (description) {
+    gst_buffer_map (description, &map, GST_MAP_READ);
+    /* configure() copies it */
+    config.set ("description", val (typed_memory_view (map.size, map.data)));
+  }
+
   GST_DEBUG_OBJECT (self, "Setting format with config: %s",
       val::global ("JSON")
           .call<val> ("stringify", config)
           .as<std::string> ()
           .c_str ());
   self->decoder.call<void> ("configure", config);
-  gst_buffer_unmap (codec_data, &map);
+  if (description) {
+    gst_buffer_unmap (description, &map);
+    gst_buffer_unref (description);
+  }
+  conf_data->ret = TRUE;
 }
 
+static void
+gst_web_codecs_audio_decoder_dtor (gpointer data)
+{
+  GstWebCodecsAudioDecoder *self = GST_WEB_CODECS_AUDIO_DECODER (data);
+
+  if (!self->has_decoder)
+    return;
+
+  if (self->decoder["state"].as<std::string> () != "closed")
+    self->decoder.call<void> ("close");
+  self->decoder = val::undefined ();
+  self->has_decoder = FALSE;
+  GST_DEBUG_OBJECT (self, "decoder closed");
+}
+
+/* Creates the decoder, unless there is one that can be reconfigured. The
+ * browser closes the decoder on errors, a new one is needed then
+ */
 static void
 gst_web_codecs_audio_decoder_ctor (gpointer data)
 {
@@ -473,6 +874,13 @@ gst_web_codecs_audio_decoder_ctor (gpointer data)
   val mod = val::global ("Module");
   val options = val::object ();
 
+  if (self->has_decoder &&
+      self->decoder["state"].as<std::string> () != "closed") {
+    GST_DEBUG_OBJECT (self, "reusing the decoder");
+    return;
+  }
+  gst_web_codecs_audio_decoder_dtor (self);
+
   /* clang-format off */
   EM_ASM ({
     const self = $0;
@@ -487,6 +895,7 @@ gst_web_codecs_audio_decoder_ctor (gpointer data)
   /* clang-format on */
 
   self->decoder = vdecclass.new_ (options);
+  self->has_decoder = TRUE;
 
   /* clang-format off */
   EM_ASM ({
@@ -502,6 +911,42 @@ gst_web_codecs_audio_decoder_ctor (gpointer data)
   GST_DEBUG_OBJECT (self, "decoder created successfully");
 }
 
+/* Drops whatever is being decoded. reset() leaves the decoder unconfigured,
+ * it is configured again with the current caps
+ */
+static void
+gst_web_codecs_audio_decoder_reset (gpointer data)
+{
+  GstWebCodecsAudioDecoderConfigureData *conf_data =
+      (GstWebCodecsAudioDecoderConfigureData *) data;
+  GstWebCodecsAudioDecoder *self = conf_data->self;
+
+  conf_data->ret = FALSE;
+  if (!self->has_decoder)
+    return;
+
+  if (self->decoder["state"].as<std::string> () == "closed")
+    gst_web_codecs_audio_decoder_ctor (self);
+  else
+    self->decoder.call<void> ("reset");
+  gst_web_codecs_audio_decoder_configure (conf_data);
+}
+
+/* Waits until every chunk submitted has been output */
+static void
+gst_web_codecs_audio_decoder_drain (gpointer data)
+{
+  GstWebCodecsAudioDecoder *self = GST_WEB_CODECS_AUDIO_DECODER (data);
+
+  if (!self->has_decoder ||
+      self->decoder["state"].as<std::string> () != "configured")
+    return;
+
+  GST_DEBUG_OBJECT (self, "Draining the decoder");
+  self->decoder.call<val> ("flush").await ();
+  GST_DEBUG_OBJECT (self, "Decoder drained");
+}
+
 /* Called with the streaming lock taken */
 static gboolean
 gst_web_codecs_audio_decoder_negotiate (GstAudioDecoder *decoder)
@@ -557,6 +1002,18 @@ gst_web_codecs_audio_decoder_handle_frame (
   GstWebCodecsAudioDecoderDecodeData *decode_data;
   GstFlowReturn res = GST_FLOW_OK;
 
+  if (self->failed)
+    return GST_FLOW_ERROR;
+
+  /* EOS or a discontinuity, the outputs must arrive before going on */
+  if (!buffer) {
+    GST_AUDIO_DECODER_STREAM_UNLOCK (self);
+    gst_web_runner_send_message (
+        self->runner, gst_web_codecs_audio_decoder_drain, self);
+    GST_AUDIO_DECODER_STREAM_LOCK (self);
+    return GST_FLOW_OK;
+  }
+
   GST_DEBUG_OBJECT (self,
       "Handling frame with buffer at %" GST_TIME_FORMAT
       " with duration %" GST_TIME_FORMAT,
@@ -600,6 +1057,14 @@ gst_web_codecs_audio_decoder_set_format (
   GST_INFO_OBJECT (
       self, "Setting format with sink caps %" GST_PTR_FORMAT, caps);
 
+  /* Keep the input state available, the error recovery configures a new
+   * decoder with it */
+  gst_caps_replace (&self->input_caps, caps);
+  self->failed = FALSE;
+  self->recoveries = 0;
+
+  /* The outputs take the streaming lock on the runner */
+  GST_AUDIO_DECODER_STREAM_UNLOCK (self);
   gst_web_runner_send_message (
       self->runner, gst_web_codecs_audio_decoder_ctor, self);
   /* Configure */
@@ -607,22 +1072,41 @@ gst_web_codecs_audio_decoder_set_format (
   conf_data.caps = caps;
   gst_web_runner_send_message (
       self->runner, gst_web_codecs_audio_decoder_configure, &conf_data);
+  GST_AUDIO_DECODER_STREAM_LOCK (self);
 
-  /* Keep the input state available */
-  if (self->input_caps)
-    gst_caps_unref (self->input_caps);
-  self->input_caps = gst_caps_ref (caps);
-
-  return TRUE;
+  return conf_data.ret;
 }
 
+/* A hard flush comes from a seek, the pending chunks are dropped. A soft
+ * one follows a drain, there is nothing left to drop
+ */
 static void
 gst_web_codecs_audio_decoder_flush (GstAudioDecoder *decoder, gboolean hard)
 {
   GstWebCodecsAudioDecoder *self = GST_WEB_CODECS_AUDIO_DECODER (decoder);
+  GstWebCodecsAudioDecoderConfigureData conf_data;
+
+  GST_DEBUG_OBJECT (self, "Flushing, hard: %d", hard);
+  if (!hard || !self->runner || !self->input_caps)
+    return;
 
-  GST_DEBUG_OBJECT (self, "Flushing");
-  // TODO: Implement.
+  conf_data.self = self;
+  conf_data.caps = gst_caps_ref (self->input_caps);
+  GST_AUDIO_DECODER_STREAM_UNLOCK (self);
+  gst_web_runner_send_message (
+      self->runner, gst_web_codecs_audio_decoder_reset, &conf_data);
+  GST_AUDIO_DECODER_STREAM_LOCK (self);
+  gst_caps_unref (conf_data.caps);
+  if (!conf_data.ret)
+    GST_WARNING_OBJECT (self, "Impossible to reconfigure the decoder");
+
+  gst_web_codecs_stats_flush (&self->stats);
+  self->recoveries = 0;
+
+  g_mutex_lock (&self->dequeue_lock);
+  self->dequeue_size = 0;
+  g_cond_signal (&self->dequeue_cond);
+  g_mutex_unlock (&self->dequeue_lock);
   GST_DEBUG_OBJECT (self, "Flushed");
 }
 
@@ -654,17 +1138,67 @@ gst_web_codecs_audio_decoder_stop (GstAudioDecoder *decoder)
   GstWebCodecsAudioDecoder *self = GST_WEB_CODECS_AUDIO_DECODER (decoder);
 
   GST_DEBUG_OBJECT (self, "Stop");
-  /* TODO Call reset */
+  if (self->runner) {
+    gst_web_runner_send_message (
+        self->runner, gst_web_codecs_audio_decoder_dtor, self);
+  }
 
   g_clear_pointer (&self->runner, gst_object_unref);
   g_clear_pointer (&self->input_caps, gst_caps_unref);
   g_clear_pointer (&self->output_caps, gst_caps_unref);
+  g_clear_pointer (&self->copy_format, g_free);
+  self->copy_per_plane = FALSE;
+  gst_web_codecs_audio_decoder_clear_pool (self);
+  gst_web_codecs_stats_reset (&self->stats);
+  self->dequeue_size = 0;
+  self->recoveries = 0;
+  self->failed = FALSE;
 
   GST_DEBUG_OBJECT (self, "Stopped");
 
   return TRUE;
 }
 
+static void
+gst_web_codecs_audio_decoder_set_property (
+    GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  GstWebCodecsAudioDecoder *self = GST_WEB_CODECS_AUDIO_DECODER (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_STATS_INTERVAL:
+      self->stats_interval = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gst_web_codecs_audio_decoder_get_property (
+    GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  GstWebCodecsAudioDecoder *self = GST_WEB_CODECS_AUDIO_DECODER (object);
+
+  switch (prop_id) {
+    case PROP_STATS:
+      g_value_take_boxed (
+          value, gst_web_codecs_audio_decoder_create_stats (self));
+      break;
+    case PROP_STATS_INTERVAL:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->stats_interval);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_web_codecs_audio_decoder_finalize (GObject *object)
 {
@@ -672,6 +1206,7 @@ gst_web_codecs_audio_decoder_finalize (GObject *object)
 
   g_mutex_clear (&self->dequeue_lock);
   g_cond_clear (&self->dequeue_cond);
+  gst_web_codecs_stats_clear (&self->stats);
 
   GST_DEBUG_OBJECT (self, "End of finalize");
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -681,6 +1216,8 @@ static void
 gst_web_codecs_audio_decoder_init (
     GstWebCodecsAudioDecoder *self, GstWebCodecsAudioDecoderClass g_class)
 {
+  self->stats_interval = DEFAULT_STATS_INTERVAL;
+  gst_web_codecs_stats_init (&self->stats);
   g_mutex_init (&self->dequeue_lock);
   g_cond_init (&self->dequeue_cond);
 }
@@ -719,7 +1256,23 @@ gst_web_codecs_audio_decoder_class_init (
   GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
   GstAudioDecoderClass *audio_decoder_class = GST_AUDIO_DECODER_CLASS (klass);
 
+  gobject_class->set_property = gst_web_codecs_audio_decoder_set_property;
+  gobject_class->get_property = gst_web_codecs_audio_decoder_get_property;
   gobject_class->finalize = gst_web_codecs_audio_decoder_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Decoder statistics: the chunks submitted, the frames output, the "
+          "errors, the decode latency percentiles in nanoseconds and the "
+          "histogram of the queue depths",
+          GST_TYPE_STRUCTURE,
+          (GParamFlags) (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_STATS_INTERVAL,
+      g_param_spec_uint ("stats-interval", "Statistics interval",
+          "Milliseconds between the webcodecs-stats element messages with "
+          "the content of the stats property, 0 to disable them",
+          0, G_MAXUINT, DEFAULT_STATS_INTERVAL,
+          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
   gst_element_class_set_static_metadata (element_class,
       "WebCodecs base audio decoder", "Codec/Decoder/Audio",
       "decode streams using WebCodecs API",
@@ -36,6 +36,8 @@
 #include <gst/web/gstwebcanvas.h>
 #include <gst/web/gstwebrunner.h>
 
+#include "gstwebcodecsstats.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_WEB_CODECS_AUDIO_DECODER                                     \
@@ -67,10 +69,27 @@ struct _GstWebCodecsAudioDecoder
   GstCaps *input_caps;
   GstCaps *output_caps;
   GstAudioInfo output_info;
+  /* The AudioData format to copy to, interleaved when downstream accepts
+   * it whatever the decoder outputs */
+  gchar *copy_format;
+  /* copyTo() threw NotSupportedError converting to copy_format, the planes
+   * are copied one by one and interleaved here */
+  gboolean copy_per_plane;
+  /* Sized at negotiation for the largest AudioData the codec outputs */
+  GstBufferPool *pool;
+  gsize pool_size;
 
   /* TODO: Move this to a prv struct */
   gboolean need_negotiation;
+  /* Decoders recreated after an error since the last output */
+  guint recoveries;
+  gboolean failed;
+
+  guint stats_interval;
+  GstWebCodecsStats stats;
 
+  /* Whether the decoder was created, it is only touched on the runner */
+  gboolean has_decoder;
   emscripten::val decoder;
   /* Amount of the output frames pending to be dequeued */
   gint dequeue_size;
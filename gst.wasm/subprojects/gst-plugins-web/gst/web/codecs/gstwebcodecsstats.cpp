@@ -0,0 +1,273 @@
+/*
+ * GStreamer - gst.wasm WebCodecs decoder statistics
+ *
+ * Copyright 2025 Fluendo S.A.
+ * @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Counters shared by the WebCodecs decoders. Chunks are submitted and
+ * decoded on the runner while the stats are read from any thread, so every
+ * call takes the lock. The decode latency of a chunk is the time from its
+ * decode() to the output with the same timestamp, outputs can be reordered.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gstwebcodecsstats.h"
+
+/* Bounds the chunks tracked, the ones never output (skipped by the
+ * browser or lost on errors) are forgotten from the oldest
+ */
+#define GST_WEB_CODECS_STATS_MAX_PENDING 64
+
+typedef struct _GstWebCodecsStatsPending
+{
+  gint64 timestamp;
+  gint64 submit_time;
+} GstWebCodecsStatsPending;
+
+static gint
+gst_web_codecs_stats_compare_latency (const void *a, const void *b)
+{
+  GstClockTime la = *(const GstClockTime *) a;
+  GstClockTime lb = *(const GstClockTime *) b;
+
+  return la < lb ? -1 : la > lb ? 1 : 0;
+}
+
+/* @sorted has @n latencies, @n > 0 */
+static GstClockTime
+gst_web_codecs_stats_percentile (
+    const GstClockTime *sorted, guint n, guint percentile)
+{
+  return sorted[MIN (n - 1, n * percentile / 100)];
+}
+
+void
+gst_web_codecs_stats_init (GstWebCodecsStats *stats)
+{
+  g_mutex_init (&stats->lock);
+  g_queue_init (&stats->pending);
+  gst_web_codecs_stats_reset (stats);
+}
+
+void
+gst_web_codecs_stats_clear (GstWebCodecsStats *stats)
+{
+  gst_web_codecs_stats_reset (stats);
+  g_mutex_clear (&stats->lock);
+}
+
+void
+gst_web_codecs_stats_reset (GstWebCodecsStats *stats)
+{
+  g_mutex_lock (&stats->lock);
+  stats->submitted = 0;
+  stats->output = 0;
+  stats->errors = 0;
+  g_queue_clear_full (&stats->pending, g_free);
+  stats->n_latencies = 0;
+  stats->next_latency = 0;
+  memset (stats->queue_depths, 0, sizeof (stats->queue_depths));
+  stats->last_post = 0;
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * gst_web_codecs_stats_submit:
+ * @stats: the stats
+ * @timestamp: the timestamp of the chunk, -1 if it has none
+ *
+ * Accounts a chunk given to decode()
+ */
+void
+gst_web_codecs_stats_submit (GstWebCodecsStats *stats, gint64 timestamp)
+{
+  GstWebCodecsStatsPending *pending;
+
+  g_mutex_lock (&stats->lock);
+  stats->submitted++;
+  if (timestamp >= 0) {
+    if (stats->pending.length >= GST_WEB_CODECS_STATS_MAX_PENDING)
+      g_free (g_queue_pop_head (&stats->pending));
+    pending = g_new (GstWebCodecsStatsPending, 1);
+    pending->timestamp = timestamp;
+    pending->submit_time = g_get_monotonic_time ();
+    g_queue_push_tail (&stats->pending, pending);
+  }
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * gst_web_codecs_stats_output:
+ * @stats: the stats
+ * @timestamp: the timestamp of the output, -1 if it has none
+ *
+ * Accounts a decoded frame, and its decode latency if the chunk of the same
+ * @timestamp was submitted
+ */
+void
+gst_web_codecs_stats_output (GstWebCodecsStats *stats, gint64 timestamp)
+{
+  GList *l;
+
+  g_mutex_lock (&stats->lock);
+  stats->output++;
+  for (l = stats->pending.head; l && timestamp >= 0; l = l->next) {
+    GstWebCodecsStatsPending *pending = (GstWebCodecsStatsPending *) l->data;
+
+    if (pending->timestamp != timestamp)
+      continue;
+
+    stats->latencies[stats->next_latency] =
+        (g_get_monotonic_time () - pending->submit_time) * GST_USECOND;
+    stats->next_latency =
+        (stats->next_latency + 1) % GST_WEB_CODECS_STATS_LATENCY_SAMPLES;
+    stats->n_latencies =
+        MIN (stats->n_latencies + 1, GST_WEB_CODECS_STATS_LATENCY_SAMPLES);
+    g_free (pending);
+    g_queue_delete_link (&stats->pending, l);
+    break;
+  }
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * gst_web_codecs_stats_flush:
+ * @stats: the stats
+ *
+ * Forgets the chunks being decoded, they won't be output after a reset()
+ */
+void
+gst_web_codecs_stats_flush (GstWebCodecsStats *stats)
+{
+  g_mutex_lock (&stats->lock);
+  g_queue_clear_full (&stats->pending, g_free);
+  g_mutex_unlock (&stats->lock);
+}
+
+void
+gst_web_codecs_stats_error (GstWebCodecsStats *stats)
+{
+  g_mutex_lock (&stats->lock);
+  stats->errors++;
+  g_queue_clear_full (&stats->pending, g_free);
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * gst_web_codecs_stats_dequeue:
+ * @stats: the stats
+ * @queue_size: the decodeQueueSize on a dequeue event
+ *
+ * Accounts the queue depth in power of two buckets
+ */
+void
+gst_web_codecs_stats_dequeue (GstWebCodecsStats *stats, gint queue_size)
+{
+  guint bucket = 0;
+
+  while (queue_size > 0 && bucket < GST_WEB_CODECS_STATS_QUEUE_BUCKETS - 1) {
+    queue_size >>= 1;
+    bucket++;
+  }
+
+  g_mutex_lock (&stats->lock);
+  stats->queue_depths[bucket]++;
+  g_mutex_unlock (&stats->lock);
+}
+
+/**
+ * gst_web_codecs_stats_fill:
+ * @stats: the stats
+ * @s: the structure to fill
+ *
+ * Sets the chunks-submitted, frames-output, errors, latency-p50/p90/p99
+ * and queue-depths fields. queue-depths is an array with the amount of
+ * dequeue events for each queue depth bucket, 0, 1, 2-3, 4-7 and so on
+ */
+void
+gst_web_codecs_stats_fill (GstWebCodecsStats *stats, GstStructure *s)
+{
+  GstClockTime sorted[GST_WEB_CODECS_STATS_LATENCY_SAMPLES];
+  GValue depths = G_VALUE_INIT;
+  GValue depth = G_VALUE_INIT;
+  guint n, i;
+
+  g_value_init (&depths, GST_TYPE_ARRAY);
+  g_value_init (&depth, G_TYPE_UINT64);
+
+  g_mutex_lock (&stats->lock);
+  gst_structure_set (s, "chunks-submitted", G_TYPE_UINT64, stats->submitted,
+      "frames-output", G_TYPE_UINT64, stats->output, "errors", G_TYPE_UINT64,
+      stats->errors, NULL);
+  n = stats->n_latencies;
+  memcpy (sorted, stats->latencies, n * sizeof (GstClockTime));
+  for (i = 0; i < GST_WEB_CODECS_STATS_QUEUE_BUCKETS; i++) {
+    g_value_set_uint64 (&depth, stats->queue_depths[i]);
+    gst_value_array_append_value (&depths, &depth);
+  }
+  g_mutex_unlock (&stats->lock);
+
+  if (n) {
+    qsort (sorted, n, sizeof (GstClockTime),
+        gst_web_codecs_stats_compare_latency);
+    gst_structure_set (s, "latency-p50", G_TYPE_UINT64,
+        gst_web_codecs_stats_percentile (sorted, n, 50), "latency-p90",
+        G_TYPE_UINT64, gst_web_codecs_stats_percentile (sorted, n, 90),
+        "latency-p99", G_TYPE_UINT64,
+        gst_web_codecs_stats_percentile (sorted, n, 99), NULL);
+  }
+  gst_structure_take_value (s, "queue-depths", &depths);
+  g_value_unset (&depth);
+}
+
+/**
+ * gst_web_codecs_stats_should_post:
+ * @stats: the stats
+ * @interval: the milliseconds between messages, 0 to never post
+ *
+ * Returns: %TRUE if @interval elapsed since the last time it returned %TRUE
+ */
+gboolean
+gst_web_codecs_stats_should_post (GstWebCodecsStats *stats, guint interval)
+{
+  gint64 now;
+  gboolean ret = FALSE;
+
+  if (!interval)
+    return FALSE;
+
+  now = g_get_monotonic_time ();
+  g_mutex_lock (&stats->lock);
+  if (!stats->last_post) {
+    stats->last_post = now;
+  } else if (now - stats->last_post >= (gint64) interval * 1000) {
+    stats->last_post = now;
+    ret = TRUE;
+  }
+  g_mutex_unlock (&stats->lock);
+
+  return ret;
+}
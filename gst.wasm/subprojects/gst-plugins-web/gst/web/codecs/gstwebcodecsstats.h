@@ -0,0 +1,65 @@
+/*
+ * GStreamer - gst.wasm WebCodecs decoder statistics
+ *
+ * Copyright 2025 Fluendo S.A.
+ * @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __GST_WEB_CODECS_STATS_H__
+#define __GST_WEB_CODECS_STATS_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Amount of the last decode latencies the percentiles are computed from */
+#define GST_WEB_CODECS_STATS_LATENCY_SAMPLES 128
+/* Queue depths 0, 1, 2-3, 4-7, 8-15, 16-31 and 32 or more */
+#define GST_WEB_CODECS_STATS_QUEUE_BUCKETS 7
+
+typedef struct _GstWebCodecsStats
+{
+  /* The runner updates the stats while they are read from any thread */
+  GMutex lock;
+  guint64 submitted;
+  guint64 output;
+  guint64 errors;
+  /* Submit time of the chunks being decoded */
+  GQueue pending;
+  GstClockTime latencies[GST_WEB_CODECS_STATS_LATENCY_SAMPLES];
+  guint n_latencies;
+  guint next_latency;
+  guint64 queue_depths[GST_WEB_CODECS_STATS_QUEUE_BUCKETS];
+  gint64 last_post;
+} GstWebCodecsStats;
+
+void gst_web_codecs_stats_init (GstWebCodecsStats *stats);
+void gst_web_codecs_stats_clear (GstWebCodecsStats *stats);
+void gst_web_codecs_stats_reset (GstWebCodecsStats *stats);
+void gst_web_codecs_stats_submit (GstWebCodecsStats *stats, gint64 timestamp);
+void gst_web_codecs_stats_output (GstWebCodecsStats *stats, gint64 timestamp);
+void gst_web_codecs_stats_flush (GstWebCodecsStats *stats);
+void gst_web_codecs_stats_error (GstWebCodecsStats *stats);
+void gst_web_codecs_stats_dequeue (GstWebCodecsStats *stats, gint queue_size);
+void gst_web_codecs_stats_fill (GstWebCodecsStats *stats, GstStructure *s);
+gboolean gst_web_codecs_stats_should_post (
+    GstWebCodecsStats *stats, guint interval);
+
+G_END_DECLS
+
+#endif /* __GST_WEB_CODECS_STATS_H__ */
@@ -50,20 +50,47 @@
 
 #include "gstwebcodecs.h"
 #include "gstwebcodecsvideodecoder.h"
+#include "../gstwebglrunner.h"
+#include "utils/h264bitstream.h"
 
 using namespace emscripten;
 
 #define GST_WEB_CODECS_VIDEO_DECODER_MAX_DEQUEUE 32
+/* How late a frame can be before skipping every delta until the next
+ * keyframe */
+#define GST_WEB_CODECS_VIDEO_DECODER_QOS_KEYFRAME_THRESHOLD (GST_SECOND / 2)
+/* Outputs the decoder depth is measured over before the reported latency
+ * can go down */
+#define GST_WEB_CODECS_VIDEO_DECODER_LATENCY_WINDOW 64
+
+#define DEFAULT_LOW_LATENCY FALSE
+#define DEFAULT_HARDWARE_ACCELERATION                                         \
+  GST_WEB_CODECS_HARDWARE_ACCELERATION_NO_PREFERENCE
+#define DEFAULT_RUNNER_MODE GST_WEB_CODECS_RUNNER_MODE_AUTO
+#define DEFAULT_STATS_INTERVAL 0
 
 #define GST_CAT_DEFAULT gst_web_codecs_video_decoder_debug_category
 GST_DEBUG_CATEGORY_STATIC (gst_web_codecs_video_decoder_debug_category);
 
 static gpointer parent_class = NULL;
 
+enum
+{
+  PROP_0,
+  PROP_LOW_LATENCY,
+  PROP_HARDWARE_ACCELERATION,
+  PROP_RUNNER_MODE,
+  PROP_STATS,
+  PROP_STATS_INTERVAL,
+  PROP_LAST
+};
+
 typedef struct _GstWebCodecsVideoDecoderConfigureData
 {
   GstWebCodecsVideoDecoder *self;
-  GstVideoCodecState *state;
+  const gchar *codec;
+  /* Can be NULL, in that case the input is expected to be Annex-B */
+  GstBuffer *description;
   gboolean ret;
 } GstWebCodecsVideoDecoderConfigureData;
 
@@ -71,35 +98,268 @@ typedef struct _GstWebCodecsVideoDecoderDecodeData
 {
   GstWebCodecsVideoDecoder *self;
   GstVideoCodecFrame *frame;
+  /* The generation of the decoder the frame was submitted to */
+  gint generation;
 } GstWebCodecsVideoDecoderDecodeData;
 
-#if 0
+static void gst_web_codecs_video_decoder_ctor (gpointer data);
+
+typedef struct _GstWebCodecsVideoDecoderCopy
+{
+  GstWebCodecsVideoDecoder *self;
+  GstVideoCodecFrame *frame;
+  /* The output buffer, mapped until the browser is done with it */
+  GstVideoFrame vframe;
+  gboolean done;
+  gboolean result;
+  /* Dropped by a flush, it is freed once copied */
+  gboolean dropped;
+} GstWebCodecsVideoDecoderCopy;
+
+static void
+gst_web_codecs_video_decoder_copy_free (GstWebCodecsVideoDecoderCopy *copy)
+{
+  gst_video_frame_unmap (&copy->vframe);
+  gst_video_codec_frame_unref (copy->frame);
+  gst_object_unref (copy->self);
+  g_free (copy);
+}
+
+/* Finishes the frames copied, in the order they were output. Called with
+ * the streaming lock taken
+ */
+static void
+gst_web_codecs_video_decoder_finish_copies (GstWebCodecsVideoDecoder *self)
+{
+  GstVideoDecoder *dec = GST_VIDEO_DECODER (self);
+  GstWebCodecsVideoDecoderCopy *copy;
+
+  while ((copy = (GstWebCodecsVideoDecoderCopy *) g_queue_peek_head (
+              &self->copies)) &&
+         copy->done) {
+    GstVideoCodecFrame *frame = gst_video_codec_frame_ref (copy->frame);
+    gboolean result = copy->result;
+    GstFlowReturn flow;
+
+    g_queue_pop_head (&self->copies);
+    gst_web_codecs_video_decoder_copy_free (copy);
+    if (!result) {
+      GST_ERROR_OBJECT (self, "Impossible to copy the VideoFrame");
+      gst_video_decoder_release_frame (dec, frame);
+      continue;
+    }
+
+    flow = gst_video_decoder_finish_frame (dec, frame);
+    if (flow != GST_FLOW_OK)
+      GST_ERROR_OBJECT (self, "Flow error: %d", flow);
+  }
+}
+
+/* Drops the copies in flight, the pending ones are freed once the browser
+ * is done with their buffers. Called with the streaming lock taken
+ */
+static void
+gst_web_codecs_video_decoder_drop_copies (GstWebCodecsVideoDecoder *self)
+{
+  GstWebCodecsVideoDecoderCopy *copy;
+
+  while ((copy = (GstWebCodecsVideoDecoderCopy *) g_queue_pop_head (
+              &self->copies))) {
+    if (copy->done)
+      gst_web_codecs_video_decoder_copy_free (copy);
+    else
+      copy->dropped = TRUE;
+  }
+}
+
 static void
-gst_web_codecs_video_decoder_video_frame_to_codec_frame (
+gst_web_codecs_video_decoder_on_copied (guintptr data, bool result)
+{
+  GstWebCodecsVideoDecoderCopy *copy = (GstWebCodecsVideoDecoderCopy *) data;
+  GstWebCodecsVideoDecoder *self =
+      (GstWebCodecsVideoDecoder *) gst_object_ref (copy->self);
+
+  GST_LOG_OBJECT (self, "VideoFrame copied, result: %d", result);
+  GST_VIDEO_DECODER_STREAM_LOCK (self);
+  copy->done = TRUE;
+  copy->result = result;
+  if (copy->dropped)
+    gst_web_codecs_video_decoder_copy_free (copy);
+  else
+    gst_web_codecs_video_decoder_finish_copies (self);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+  gst_object_unref (self);
+}
+
+/* Copies the VideoFrame into the output buffer converting it to the
+ * negotiated format. The output callback can not wait for copyTo(), the
+ * frame is finished once the copy is done and the VideoFrame is closed
+ * then. Called on the runner thread with the streaming lock taken
+ */
+static gboolean
+gst_web_codecs_video_decoder_copy_frame (
     GstWebCodecsVideoDecoder *self, val video_frame, GstVideoCodecFrame *frame)
 {
-  GstMapInfo map;
-  val buffer_data;
-  val options;
-
-  GST_DEBUG_OBJECT (self, "Converting frame to C memory");
-  /* destination buffer */
-  /* map the buffer into an ArrayBuffer */
-  gst_buffer_map (frame->output_buffer, &map, GST_MAP_WRITE);
-  buffer_data = val (typed_memory_view (map.size, map.data));
-  /* set the options */
-  options = val::object ();
-  /* Get the format from the output format */
-  /* FIXME if the format is not of any rgb type, it complains and we must not
-   * set it Also, we need to specify properly the layout of the planes. Check
-   * allocationSize()
+  GstWebCodecsVideoDecoderCopy *copy;
+  GstVideoInfo *info = &self->output_state->info;
+  val options = val::object ();
+  val layout = val::array ();
+  val plane = val::object ();
+  val rect = val::object ();
+  val visible_rect = video_frame["visibleRect"];
+  val data;
+  gsize size;
+
+  copy = g_new0 (GstWebCodecsVideoDecoderCopy, 1);
+  if (!gst_video_frame_map (
+          &copy->vframe, info, frame->output_buffer, GST_MAP_WRITE)) {
+    GST_ERROR_OBJECT (self, "Impossible to map the output buffer");
+    g_free (copy);
+    return FALSE;
+  }
+  copy->self = (GstWebCodecsVideoDecoder *) gst_object_ref (self);
+  copy->frame = gst_video_codec_frame_ref (frame);
+
+  /* Honour the strides of the downstream pool, the RGB formats have a
+   * single plane. Copy the size of the output, whatever the visible
+   * rectangle is
    */
+  size = GST_VIDEO_FRAME_PLANE_STRIDE (&copy->vframe, 0) *
+         GST_VIDEO_FRAME_COMP_HEIGHT (&copy->vframe, 0);
+  data = val (typed_memory_view (
+      size, (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&copy->vframe, 0)));
+  plane.set ("offset", 0);
+  plane.set ("stride", GST_VIDEO_FRAME_PLANE_STRIDE (&copy->vframe, 0));
+  layout.call<void> ("push", plane);
+  rect.set ("x", visible_rect["x"]);
+  rect.set ("y", visible_rect["y"]);
+  rect.set ("width", GST_VIDEO_INFO_WIDTH (info));
+  rect.set ("height", GST_VIDEO_INFO_HEIGHT (info));
   options.set ("format", std::string (self->output_format));
-  video_frame.call<val> ("copyTo", buffer_data, options).await ();
-  gst_buffer_unmap (frame->output_buffer, &map);
-  GST_DEBUG_OBJECT (self, "Converted frame to C memory");
+  options.set ("layout", layout);
+  options.set ("rect", rect);
+  g_queue_push_tail (&self->copies, copy);
+
+  GST_LOG_OBJECT (self, "Copying the VideoFrame into a %s buffer",
+      self->output_format);
+  /* clang-format off */
+  EM_ASM ({
+    const copy = $0;
+    const frame = Emval.toValue ($1);
+    let promise;
+
+    try {
+      promise = frame.copyTo (Emval.toValue ($2), Emval.toValue ($3));
+    } catch (e) {
+      promise = Promise.reject (e);
+    }
+    promise.then (() => {
+      frame.close ();
+      Module.gst_web_codecs_video_decoder_on_copied (copy, true);
+    }, () => {
+      frame.close ();
+      Module.gst_web_codecs_video_decoder_on_copied (copy, false);
+    });
+  }, (guintptr) copy, video_frame.as_handle (), data.as_handle (),
+      options.as_handle ());
+  /* clang-format on */
+
+  return TRUE;
+}
+
+/* The oldest frame not being copied, the frames are output in order */
+static GstVideoCodecFrame *
+gst_web_codecs_video_decoder_get_output_frame (GstWebCodecsVideoDecoder *self)
+{
+  GList *frames = gst_video_decoder_get_frames (GST_VIDEO_DECODER (self));
+  GstVideoCodecFrame *frame;
+
+  frame = (GstVideoCodecFrame *) g_list_nth_data (
+      frames, g_queue_get_length (&self->copies));
+  if (frame)
+    gst_video_codec_frame_ref (frame);
+  g_list_free_full (frames, (GDestroyNotify) gst_video_codec_frame_unref);
+
+  return frame;
+}
+
+/* Picks the system memory format VideoFrame.copyTo() can convert to that
+ * downstream accepts, only when downstream does not accept VideoFrames
+ */
+static const gchar *
+gst_web_codecs_video_decoder_get_copy_format (GstWebCodecsVideoDecoder *self)
+{
+  static const gchar *formats[] = { "RGBA", "RGBx", "BGRA", "BGRx" };
+  GstCapsFeatures *features;
+  GstCaps *peer_caps;
+  const gchar *ret = NULL;
+  guint i;
+
+  peer_caps = gst_pad_peer_query_caps (GST_VIDEO_DECODER_SRC_PAD (self), NULL);
+  if (gst_caps_is_any (peer_caps) || gst_caps_is_empty (peer_caps))
+    goto done;
+
+  for (i = 0; i < gst_caps_get_size (peer_caps); i++) {
+    features = gst_caps_get_features (peer_caps, i);
+    if (features && gst_caps_features_contains (
+                        features, GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME))
+      goto done;
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (formats) && !ret; i++) {
+    GstCaps *caps = gst_caps_new_simple (
+        "video/x-raw", "format", G_TYPE_STRING, formats[i], NULL);
+
+    if (gst_caps_can_intersect (caps, peer_caps))
+      ret = formats[i];
+    gst_caps_unref (caps);
+  }
+
+done:
+  gst_caps_unref (peer_caps);
+  return ret;
+}
+
+static GstVideoFormat
+gst_web_codecs_video_decoder_format_from_string (const gchar *vf_format)
+{
+  if (!g_strcmp0 (vf_format, "I420"))
+    return GST_VIDEO_FORMAT_I420;
+  else if (!g_strcmp0 (vf_format, "I420A"))
+    return GST_VIDEO_FORMAT_A420;
+  else if (!g_strcmp0 (vf_format, "I422"))
+    return GST_VIDEO_FORMAT_Y42B;
+  else if (!g_strcmp0 (vf_format, "I444"))
+    return GST_VIDEO_FORMAT_Y444;
+  else if (!g_strcmp0 (vf_format, "NV12"))
+    return GST_VIDEO_FORMAT_NV12;
+  else if (!g_strcmp0 (vf_format, "RGBA"))
+    return GST_VIDEO_FORMAT_RGBA;
+  else if (!g_strcmp0 (vf_format, "RGBX"))
+    return GST_VIDEO_FORMAT_RGBx;
+  else if (!g_strcmp0 (vf_format, "BGRA"))
+    return GST_VIDEO_FORMAT_BGRA;
+  else if (!g_strcmp0 (vf_format, "BGRX"))
+    return GST_VIDEO_FORMAT_BGRx;
+
+  return GST_VIDEO_FORMAT_UNKNOWN;
+}
+
+/* Whether the VideoFrame does not match the negotiated output anymore, like
+ * on a resolution switch of an adaptive stream
+ */
+static gboolean
+gst_web_codecs_video_decoder_format_changed (
+    GstWebCodecsVideoDecoder *self, val video_frame)
+{
+  std::string vf_format = video_frame["format"].as<std::string> ();
+  GstVideoFormat format =
+      gst_web_codecs_video_decoder_format_from_string (vf_format.c_str ());
+
+  return video_frame["displayWidth"].as<int> () != self->width ||
+         video_frame["displayHeight"].as<int> () != self->height ||
+         format != self->frame_format;
 }
-#endif
 
 static gboolean
 gst_web_codecs_video_decoder_get_format (
@@ -114,29 +374,28 @@ gst_web_codecs_video_decoder_get_format (
 
   /* Get the video frame format */
   vf_format = vf_format_str.c_str ();
-  if (!g_strcmp0 (vf_format, "I420")) {
-    format = GST_VIDEO_FORMAT_I420;
-  } else if (!g_strcmp0 (vf_format, "I420A")) {
-    format = GST_VIDEO_FORMAT_A420;
-  } else if (!g_strcmp0 (vf_format, "I422")) {
-    format = GST_VIDEO_FORMAT_Y42B;
-  } else if (!g_strcmp0 (vf_format, "I444")) {
-    format = GST_VIDEO_FORMAT_Y444;
-  } else if (!g_strcmp0 (vf_format, "NV12")) {
-    format = GST_VIDEO_FORMAT_NV12;
-  } else if (!g_strcmp0 (vf_format, "RGBA")) {
-    format = GST_VIDEO_FORMAT_RGBA;
-  } else if (!g_strcmp0 (vf_format, "RGBX")) {
-    format = GST_VIDEO_FORMAT_RGBx;
-  } else if (!g_strcmp0 (vf_format, "BGRA")) {
-    format = GST_VIDEO_FORMAT_BGRA;
-  } else if (!g_strcmp0 (vf_format, "BGRX")) {
-    format = GST_VIDEO_FORMAT_BGRx;
-  } else {
+  format = gst_web_codecs_video_decoder_format_from_string (vf_format);
+  if (format == GST_VIDEO_FORMAT_UNKNOWN) {
     GST_ERROR_OBJECT (self, "Unsupported format %s", vf_format);
     goto done;
   }
+  self->frame_format = format;
+  g_free (self->output_format);
   self->output_format = g_strdup (vf_format);
+  self->system_memory = FALSE;
+  if (!self->gl) {
+    const gchar *copy_format =
+        gst_web_codecs_video_decoder_get_copy_format (self);
+
+    if (copy_format) {
+      GST_INFO_OBJECT (self, "Downstream needs system memory, copying to %s",
+          copy_format);
+      self->system_memory = TRUE;
+      format = gst_video_format_from_string (copy_format);
+      g_free (self->output_format);
+      self->output_format = g_ascii_strup (copy_format, -1);
+    }
+  }
   width = video_frame["displayWidth"].as<int> ();
   height = video_frame["displayHeight"].as<int> ();
 
@@ -153,6 +412,170 @@ done:
   return ret;
 }
 
+/* Called with the streaming lock taken. The depth is measured again, do
+ * not report the one of the previous stream until then */
+static void
+gst_web_codecs_video_decoder_reset_latency (GstWebCodecsVideoDecoder *self)
+{
+  if (self->latency_depth)
+    gst_video_decoder_set_latency (GST_VIDEO_DECODER (self), 0, 0);
+  self->latency_depth = 0;
+  self->window_depth = 0;
+  self->window_outputs = 0;
+}
+
+/* Called with the streaming lock taken, on the runner. The chunks not
+ * output yet are the frames the decoder holds to reorder them only when
+ * none is waiting in its queue, the ones queued behind a slow or stalled
+ * decode do not add latency once it catches up. The depth goes up at once
+ * and down after a window of outputs without reaching it
+ */
+static void
+gst_web_codecs_video_decoder_update_latency (GstWebCodecsVideoDecoder *self)
+{
+  GstVideoInfo *info;
+  GstClockTime latency;
+  /* The frames the browser holds before giving us this one */
+  gint depth = self->in_flight - 1;
+  gint new_depth;
+
+  if (!self->input_state ||
+      self->decoder["decodeQueueSize"].as<int> () > 0)
+    return;
+
+  self->window_depth = MAX (self->window_depth, depth);
+  self->window_outputs++;
+  new_depth = self->latency_depth;
+  if (depth > self->latency_depth) {
+    new_depth = depth;
+  } else if (self->window_outputs >=
+             GST_WEB_CODECS_VIDEO_DECODER_LATENCY_WINDOW) {
+    new_depth = self->window_depth;
+  }
+  if (self->window_outputs >= GST_WEB_CODECS_VIDEO_DECODER_LATENCY_WINDOW) {
+    self->window_depth = 0;
+    self->window_outputs = 0;
+  }
+  if (new_depth == self->latency_depth)
+    return;
+
+  self->latency_depth = new_depth;
+  info = &self->input_state->info;
+  if (info->fps_n <= 0 || info->fps_d <= 0) {
+    GST_DEBUG_OBJECT (self, "Unknown framerate, can not report latency");
+    return;
+  }
+
+  latency = gst_util_uint64_scale (
+      self->latency_depth * GST_SECOND, info->fps_d, info->fps_n);
+  GST_INFO_OBJECT (self,
+      "Decoder depth is %d frames, latency %" GST_TIME_FORMAT,
+      self->latency_depth, GST_TIME_ARGS (latency));
+  gst_video_decoder_set_latency (GST_VIDEO_DECODER (self), latency, latency);
+}
+
+/* Called with the streaming lock taken. After an accurate seek the decoding
+ * starts from the previous keyframe, the frames before the seek target are
+ * only needed to decode the next ones
+ */
+static gboolean
+gst_web_codecs_video_decoder_is_outside_segment (
+    GstWebCodecsVideoDecoder *self, GstVideoCodecFrame *frame)
+{
+  GstSegment *segment = &GST_VIDEO_DECODER (self)->output_segment;
+  GstClockTime stop;
+
+  if (GST_VIDEO_CODEC_FRAME_IS_DECODE_ONLY (frame))
+    return TRUE;
+
+  if (segment->format != GST_FORMAT_TIME ||
+      !GST_CLOCK_TIME_IS_VALID (frame->pts))
+    return FALSE;
+
+  stop = frame->pts;
+  if (GST_CLOCK_TIME_IS_VALID (frame->duration))
+    stop += frame->duration;
+
+  return !gst_segment_clip (
+      segment, GST_FORMAT_TIME, frame->pts, stop, NULL, NULL);
+}
+
+static GstStructure *
+gst_web_codecs_video_decoder_create_stats (GstWebCodecsVideoDecoder *self)
+{
+  GstWebCodecsHardwareAcceleration hardware_acceleration;
+  GstStructure *stats;
+
+  g_mutex_lock (&self->stats_lock);
+  stats = gst_structure_new ("application/x-webcodecs-video-decoder-stats",
+      "failovers", G_TYPE_UINT, self->failovers, "last-downtime",
+      G_TYPE_UINT64, self->last_downtime, "total-downtime", G_TYPE_UINT64,
+      self->total_downtime, "skipped", G_TYPE_UINT64, self->skipped,
+      "dropped", G_TYPE_UINT64, self->dropped, NULL);
+  GST_OBJECT_LOCK (self);
+  hardware_acceleration = self->hardware_acceleration;
+  GST_OBJECT_UNLOCK (self);
+  if (self->software_fallback)
+    hardware_acceleration =
+        GST_WEB_CODECS_HARDWARE_ACCELERATION_PREFER_SOFTWARE;
+  gst_structure_set (stats, "hardware-acceleration", G_TYPE_STRING,
+      gst_web_codecs_hardware_acceleration_to_string (hardware_acceleration),
+      NULL);
+  g_mutex_unlock (&self->stats_lock);
+  gst_web_codecs_stats_fill (&self->stats, stats);
+
+  return stats;
+}
+
+static void
+gst_web_codecs_video_decoder_post_stats (GstWebCodecsVideoDecoder *self)
+{
+  GstStructure *stats;
+  guint interval;
+
+  GST_OBJECT_LOCK (self);
+  interval = self->stats_interval;
+  GST_OBJECT_UNLOCK (self);
+
+  if (!gst_web_codecs_stats_should_post (&self->stats, interval))
+    return;
+
+  stats = gst_web_codecs_video_decoder_create_stats (self);
+  gst_structure_set_name (stats, "webcodecs-stats");
+  gst_element_post_message (GST_ELEMENT (self),
+      gst_message_new_element (GST_OBJECT (self), stats));
+}
+
+/* Called on the GL thread */
+static void
+gst_web_codecs_video_decoder_upload_gl (
+    GstWebCodecsVideoDecoder *self, val video_frame, GstBuffer *buffer)
+{
+  GstGLMemory *gl_mem = (GstGLMemory *) gst_buffer_peek_memory (buffer, 0);
+  GstGLSyncMeta *sync_meta;
+
+  /* clang-format off */
+  EM_ASM ({
+    const gl = GL.currentContext.GLctx;
+    const frame = Emval.toValue ($1);
+
+    gl.bindTexture (gl.TEXTURE_2D, GL.textures[$0]);
+    gl.texSubImage2D (gl.TEXTURE_2D, 0, 0, 0, gl.RGBA, gl.UNSIGNED_BYTE,
+        frame);
+    gl.bindTexture (gl.TEXTURE_2D, null);
+  }, gst_gl_memory_get_texture_id (gl_mem), video_frame.as_handle ());
+  /* clang-format on */
+
+  /* The texture is the only valid copy now */
+  GST_MINI_OBJECT_FLAG_UNSET (
+      gl_mem, GST_GL_BASE_MEMORY_TRANSFER_NEED_UPLOAD);
+  GST_MINI_OBJECT_FLAG_SET (gl_mem, GST_GL_BASE_MEMORY_TRANSFER_NEED_DOWNLOAD);
+
+  sync_meta = gst_buffer_get_gl_sync_meta (buffer);
+  if (sync_meta)
+    gst_gl_sync_meta_set_sync_point (sync_meta, self->gl_context);
+}
+
 static void
 gst_web_codecs_video_decoder_on_output (guintptr self_, val video_frame)
 {
@@ -164,46 +587,96 @@ gst_web_codecs_video_decoder_on_output (guintptr self_, val video_frame)
 
   GST_INFO_OBJECT (self, "VideoFrame Received");
 
+  gst_web_codecs_stats_output (
+      &self->stats, (gint64) video_frame["timestamp"].as<double> ());
+
   GST_VIDEO_DECODER_STREAM_LOCK (self);
-  frame = gst_video_decoder_get_oldest_frame (GST_VIDEO_DECODER (self));
+  gst_web_codecs_video_decoder_update_latency (self);
+  if (self->in_flight > 0)
+    self->in_flight--;
+  if (self->error_time) {
+    g_mutex_lock (&self->stats_lock);
+    self->last_downtime =
+        (g_get_monotonic_time () - self->error_time) * GST_USECOND;
+    self->total_downtime += self->last_downtime;
+    g_mutex_unlock (&self->stats_lock);
+    self->error_time = 0;
+    GST_INFO_OBJECT (self, "Recovered from error after %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (self->last_downtime));
+    gst_element_post_message (GST_ELEMENT (self),
+        gst_message_new_element (GST_OBJECT (self),
+            gst_structure_new ("webcodecs-recovered", "downtime",
+                G_TYPE_UINT64, self->last_downtime, NULL)));
+  }
+  frame = gst_web_codecs_video_decoder_get_output_frame (self);
+  if (!frame) {
+    GST_DEBUG_OBJECT (self, "No frame pending, dropped by a flush");
+    video_frame.call<void> ("close");
+    goto done;
+  }
   GST_DEBUG_OBJECT (self,
       "queued frame %" GST_TIME_FORMAT " decoded frame %" GST_TIME_FORMAT,
       GST_TIME_ARGS (frame->pts),
       GST_TIME_ARGS (GST_MSECOND * video_frame["timestamp"].as<int> ()));
 
-  /* Configure the output */
-  if (!self->output_state) {
-    self->need_negotiation = TRUE;
-    gst_web_codecs_video_decoder_get_format (self, video_frame);
-  }
-  /* FIXME If we want to push video_frames directly or glTextures, we need
-   * to create the buffers ourselves
-   */
-#if 0
-  flow = gst_video_decoder_allocate_output_frame (dec, frame);
-
-  GST_ERROR_OBJECT (self, "Output caps are %" GST_PTR_FORMAT,
-      self->output_state->allocation_caps);
-
-  if (flow != GST_FLOW_OK) {
-    GST_ERROR_OBJECT (self, "Flow error: %d", flow);
+  /* Do not wrap, copy nor upload what the base class would clip */
+  if (gst_web_codecs_video_decoder_is_outside_segment (self, frame)) {
+    GST_LOG_OBJECT (self, "Frame %" GST_TIME_FORMAT " is outside the segment",
+        GST_TIME_ARGS (frame->pts));
+    video_frame.call<void> ("close");
+    gst_video_decoder_release_frame (dec, frame);
+    frame = NULL;
     goto done;
   }
 
-  /* In a software based pipeline we need to extract the video data
-   * in the format the sink element requires
-   */
-  gst_web_codecs_video_decoder_video_frame_to_codec_frame (self, video_frame,
-      frame);
-#endif
+  /* Configure the output, again if the stream changed on the fly */
+  if (!self->output_state ||
+      gst_web_codecs_video_decoder_format_changed (self, video_frame)) {
+    self->need_negotiation = TRUE;
+    gst_web_codecs_video_decoder_get_format (self, video_frame);
+  }
   /* In this moment we have already negotiated downstream, we can safely push
    * buffers */
-  {
+  if (self->gl) {
+    /* We are on the GL thread, the texture is filled right away */
+    flow = gst_video_decoder_allocate_output_frame (dec, frame);
+    if (flow == GST_FLOW_OK) {
+      gst_web_codecs_video_decoder_upload_gl (
+          self, video_frame, frame->output_buffer);
+    }
+    video_frame.call<void> ("close");
+    if (flow != GST_FLOW_OK) {
+      GST_ERROR_OBJECT (self, "Impossible to allocate a GL buffer: %s",
+          gst_flow_get_name (flow));
+      gst_video_decoder_release_frame (dec, frame);
+      frame = NULL;
+      goto done;
+    }
+  } else if (self->system_memory) {
+    /* One copy straight into the downstream buffer, the VideoFrame is
+     * closed and the frame finished once done
+     */
+    flow = gst_video_decoder_allocate_output_frame (dec, frame);
+    if (flow == GST_FLOW_OK &&
+        !gst_web_codecs_video_decoder_copy_frame (self, video_frame, frame))
+      flow = GST_FLOW_ERROR;
+    if (flow != GST_FLOW_OK) {
+      GST_ERROR_OBJECT (self, "Impossible to copy the VideoFrame: %s",
+          gst_flow_get_name (flow));
+      video_frame.call<void> ("close");
+      gst_video_decoder_release_frame (dec, frame);
+      frame = NULL;
+      goto done;
+    }
+    gst_video_codec_frame_unref (frame);
+    frame = NULL;
+    goto done;
+  } else {
     GstBuffer *b;
     GstWebRunner *runner;
     GstWebVideoFrame *memory;
 
-    runner = gst_web_canvas_get_runner (self->canvas);
+    runner = (GstWebRunner *) gst_object_ref (self->runner);
     memory = gst_web_video_frame_wrap (video_frame, runner);
     b = gst_buffer_new ();
     gst_buffer_insert_memory (b, -1, GST_MEMORY_CAST (memory));
@@ -223,13 +696,69 @@ done:
     gst_video_codec_frame_unref (frame);
 
   GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+
+  gst_web_codecs_video_decoder_post_stats (self);
 }
 
 static void
 gst_web_codecs_video_decoder_on_error (guintptr self_, val error)
 {
-  /* TODO handle this */
-  GST_ERROR ("Error received");
+  GstWebCodecsVideoDecoder *self = (GstWebCodecsVideoDecoder *) self_;
+  GstVideoDecoder *dec = GST_VIDEO_DECODER (self);
+  GstWebCodecsHardwareAcceleration hardware_acceleration;
+  GList *frames, *l;
+  std::string reason = error["message"].as<std::string> ();
+
+  GST_WARNING_OBJECT (self, "Error received: %s", reason.c_str ());
+  gst_web_codecs_stats_error (&self->stats);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (self);
+  /* The browser closes the decoder on error, whatever was submitted is
+   * lost */
+  frames = gst_video_decoder_get_frames (dec);
+  for (l = frames; l; l = l->next)
+    gst_video_decoder_release_frame (dec, (GstVideoCodecFrame *) l->data);
+  g_list_free (frames);
+  g_atomic_int_inc (&self->generation);
+  self->in_flight = 0;
+  self->configured = FALSE;
+  self->annexb_to_avc = FALSE;
+
+  GST_OBJECT_LOCK (self);
+  hardware_acceleration = self->hardware_acceleration;
+  GST_OBJECT_UNLOCK (self);
+
+  if (self->software_fallback ||
+      hardware_acceleration ==
+          GST_WEB_CODECS_HARDWARE_ACCELERATION_PREFER_SOFTWARE) {
+    self->failed = TRUE;
+    GST_ELEMENT_ERROR (self, STREAM, DECODE, (NULL),
+        ("Software decoder failed: %s", reason.c_str ()));
+  } else {
+    /* Start over with a software decoder from the next keyframe, we are
+     * already on the runner */
+    gst_web_codecs_video_decoder_ctor (self);
+    g_mutex_lock (&self->stats_lock);
+    self->software_fallback = TRUE;
+    self->failovers++;
+    g_mutex_unlock (&self->stats_lock);
+    if (!self->error_time)
+      self->error_time = g_get_monotonic_time ();
+    gst_element_post_message (GST_ELEMENT (self),
+        gst_message_new_element (GST_OBJECT (self),
+            gst_structure_new ("webcodecs-failover", "reason", G_TYPE_STRING,
+                reason.c_str (), "hardware-acceleration", G_TYPE_STRING,
+                gst_web_codecs_hardware_acceleration_to_string (
+                    GST_WEB_CODECS_HARDWARE_ACCELERATION_PREFER_SOFTWARE),
+                NULL)));
+  }
+  GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+
+  /* Unblock a handle_frame() waiting for a dequeue */
+  g_mutex_lock (&self->dequeue_lock);
+  self->dequeue_size = 0;
+  g_cond_signal (&self->dequeue_cond);
+  g_mutex_unlock (&self->dequeue_lock);
 }
 
 static void
@@ -239,6 +768,7 @@ gst_web_codecs_video_decoder_on_dequeue (guintptr self_, val event)
   gint dequeue_size;
 
   dequeue_size = self->decoder["decodeQueueSize"].as<int> ();
+  gst_web_codecs_stats_dequeue (&self->stats, dequeue_size);
 
   GST_INFO_OBJECT (
       self, "Dequeue received with current size %d", dequeue_size);
@@ -257,6 +787,8 @@ EMSCRIPTEN_BINDINGS (gst_web_codecs_video_decoder)
       &gst_web_codecs_video_decoder_on_error);
   function ("gst_web_codecs_video_decoder_on_dequeue",
       &gst_web_codecs_video_decoder_on_dequeue);
+  function ("gst_web_codecs_video_decoder_on_copied",
+      &gst_web_codecs_video_decoder_on_copied);
 }
 
 static void
@@ -267,6 +799,9 @@ gst_web_codecs_video_decoder_decode (gpointer data)
   GstWebCodecsVideoDecoder *self = decode_data->self;
   GstVideoCodecFrame *frame = decode_data->frame;
   GstMapInfo map;
+  guint8 *data;
+  guint8 *avc = NULL;
+  gsize size;
   val chunkclass = val::global ("EncodedVideoChunk");
   val options = val::object ();
 
@@ -274,6 +809,13 @@ gst_web_codecs_video_decoder_decode (gpointer data)
       "Decoding frame at %" GST_TIME_FORMAT " with duration %" GST_TIME_FORMAT,
       GST_TIME_ARGS (frame->pts), GST_TIME_ARGS (frame->duration));
 
+  /* Submitted before an error or a flush, the frame is already released */
+  if (decode_data->generation != g_atomic_int_get (&self->generation)) {
+    GST_DEBUG_OBJECT (self, "Submitted to a previous decoder, skipping frame");
+    gst_video_codec_frame_unref (frame);
+    return;
+  }
+
   /* TODO use 'transfer' option in case we provide an allocator to avoid
    * the copy. For that, we need to create the memory in JS and give the
    * ownership to it.
@@ -287,12 +829,21 @@ gst_web_codecs_video_decoder_decode (gpointer data)
   options.set (
       "type", GST_VIDEO_CODEC_FRAME_IS_SYNC_POINT (frame) ? "key" : "delta");
   gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ);
-  val buffer_data = val (typed_memory_view (map.size, map.data));
+  data = map.data;
+  size = map.size;
+  if (self->annexb_to_avc)
+    data = avc = gst_web_codecs_h264_annexb_to_avc (map.data, map.size, &size);
+  val buffer_data = val (typed_memory_view (size, data));
   options.set ("data", buffer_data);
 
   val chunk = chunkclass.new_ (options);
+  gst_web_codecs_stats_submit (&self->stats,
+      GST_CLOCK_TIME_IS_VALID (frame->pts) ? GST_TIME_AS_MSECONDS (frame->pts)
+                                           : -1);
   self->decoder.call<void> ("decode", chunk);
+  self->in_flight++;
   gst_buffer_unmap (frame->input_buffer, &map);
+  g_free (avc);
 
   gst_video_codec_frame_unref (frame);
   GST_DEBUG_OBJECT (self, "Done decoding");
@@ -304,41 +855,245 @@ gst_web_codecs_video_decoder_configure (gpointer data)
   GstWebCodecsVideoDecoderConfigureData *conf_data =
       (GstWebCodecsVideoDecoderConfigureData *) data;
   GstWebCodecsVideoDecoder *self = conf_data->self;
-  GstVideoCodecState *state = conf_data->state;
-  GstStructure *s;
-  const GValue *codec_data_value = NULL;
-  GstBuffer *codec_data = NULL;
   GstMapInfo map;
-  gchar *mime_codec;
+  val vdecclass = val::global ("VideoDecoder");
   val config = val::object ();
 
-  mime_codec = gst_codec_utils_caps_get_mime_codec (state->caps);
-  config.set ("codec", std::string (mime_codec));
-  g_free (mime_codec);
+  conf_data->ret = FALSE;
+  config.set ("codec", std::string (conf_data->codec));
 
-  s = gst_caps_get_structure (state->caps, 0);
-  codec_data_value = gst_structure_get_value (s, "codec_data");
-  if (!codec_data_value) {
-    GST_ERROR_OBJECT (self, "Caps do not have codec_data");
-    conf_data->ret = FALSE;
-    return;
+  GST_OBJECT_LOCK (self);
+  config.set ("optimizeForLatency", self->low_latency ? true : false);
+  config.set ("hardwareAcceleration",
+      std::string (gst_web_codecs_hardware_acceleration_to_string (
+          self->software_fallback
+              ? GST_WEB_CODECS_HARDWARE_ACCELERATION_PREFER_SOFTWARE
+              : self->hardware_acceleration)));
+  GST_OBJECT_UNLOCK (self);
+
+  if (self->input_state) {
+    GstVideoInfo *info = &self->input_state->info;
+    GstStructure *s = gst_caps_get_structure (self->input_state->caps, 0);
+
+    if (info->width > 0 && info->height > 0) {
+      config.set ("codedWidth", info->width);
+      config.set ("codedHeight", info->height);
+    }
+    if (gst_structure_has_field (s, "colorimetry")) {
+      config.set ("colorSpace",
+          gst_web_utils_video_colorimetry_to_web_color_space (
+              &info->colorimetry));
+    }
+  }
+
+  if (conf_data->description) {
+    if (!gst_buffer_map (conf_data->description, &map, GST_MAP_READ)) {
+      GST_ERROR_OBJECT (self, "Impossible to map the buffer");
+      return;
+    }
+    config.set ("description", val (typed_memory_view (map.size, map.data)));
+  }
+
+  /* A configure() with an unsupported config closes the decoder, check it
+   * first so the caller can try with a different one */
+  val result = vdecclass.call<val> ("isConfigSupported", config).await ();
+  if (result["supported"].as<bool> ()) {
+    GST_DEBUG_OBJECT (self, "Setting format for codec %s%s", conf_data->codec,
+        conf_data->description ? "" : " without description");
+    self->decoder.call<void> ("configure", config);
+    conf_data->ret = TRUE;
+  } else {
+    GST_INFO_OBJECT (self, "Config for codec %s%s is not supported",
+        conf_data->codec,
+        conf_data->description ? "" : " without description");
+  }
+
+  if (conf_data->description)
+    gst_buffer_unmap (conf_data->description, &map);
+}
+
+/* Called with the streaming lock taken. Whether a keyframe of a
+ * byte-stream carries a SPS different from the one the decoder is configured
+ * with, like on a resolution or profile switch of a live stream
+ */
+static gboolean
+gst_web_codecs_video_decoder_sps_changed (
+    GstWebCodecsVideoDecoder *self, GstVideoCodecFrame *frame)
+{
+  GstMapInfo map;
+  const guint8 *sps;
+  gsize sps_size;
+  gboolean ret = FALSE;
+
+  if (!self->sps || !gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ))
+    return FALSE;
+
+  if (gst_web_codecs_h264_find_nal (map.data, map.size,
+          GST_WEB_CODECS_H264_NAL_SPS, &sps, &sps_size)) {
+    ret = sps_size != g_bytes_get_size (self->sps) ||
+          memcmp (sps, g_bytes_get_data (self->sps, NULL), sps_size);
   }
+  gst_buffer_unmap (frame->input_buffer, &map);
 
-  codec_data = gst_value_get_buffer (codec_data_value);
-  if (!gst_buffer_map (codec_data, &map, GST_MAP_READ)) {
+  return ret;
+}
+
+/* Configures the decoder from the SPS/PPS found in a byte-stream frame, or
+ * from the previous ones when the frame has none, like after a flush or an
+ * error. Annex-B is sent as is, the conversion to avcC + length-prefixed
+ * NALs only happens when the browser does not support it
+ */
+static GstFlowReturn
+gst_web_codecs_video_decoder_configure_annexb (
+    GstWebCodecsVideoDecoder *self, GstVideoCodecFrame *frame)
+{
+  GstWebCodecsVideoDecoderConfigureData conf_data;
+  GstWebRunner *runner;
+  GstMapInfo map;
+  const guint8 *sps, *pps;
+  gsize sps_size, pps_size;
+  gchar *mime_codec = NULL;
+
+  if (!gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ)) {
     GST_ERROR_OBJECT (self, "Impossible to map the buffer");
-    conf_data->ret = FALSE;
-    return;
+    return GST_FLOW_ERROR;
   }
 
-  val codec_data_js = val (typed_memory_view (map.size, map.data));
-  config.set ("description", codec_data_js);
+  if (!gst_web_codecs_h264_find_nal (map.data, map.size,
+          GST_WEB_CODECS_H264_NAL_SPS, &sps, &sps_size) ||
+      !gst_web_codecs_h264_find_nal (map.data, map.size,
+          GST_WEB_CODECS_H264_NAL_PPS, &pps, &pps_size)) {
+    if (!self->sps || !self->pps) {
+      GST_DEBUG_OBJECT (self, "No in-band SPS/PPS found yet");
+      gst_buffer_unmap (frame->input_buffer, &map);
+      return GST_FLOW_OK;
+    }
+    GST_DEBUG_OBJECT (self, "Using the previous SPS/PPS");
+    sps = (const guint8 *) g_bytes_get_data (self->sps, &sps_size);
+    pps = (const guint8 *) g_bytes_get_data (self->pps, &pps_size);
+  }
 
-  GST_DEBUG_OBJECT (self, "Setting format");
-  self->decoder.call<void> ("configure", config);
-  gst_buffer_unmap (codec_data, &map);
+  if (!(mime_codec = gst_web_codecs_h264_get_mime_codec (sps, sps_size))) {
+    GST_DEBUG_OBJECT (self, "Invalid in-band SPS");
+    gst_buffer_unmap (frame->input_buffer, &map);
+    return GST_FLOW_OK;
+  }
+
+  /* Outputs are handled with the stream lock taken on the runner */
+  GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+  runner = (GstWebRunner *) gst_object_ref (self->runner);
+  conf_data.self = self;
+  conf_data.codec = mime_codec;
+  conf_data.description = NULL;
+  gst_web_runner_send_message (
+      runner, gst_web_codecs_video_decoder_configure, &conf_data);
+  self->annexb_to_avc = FALSE;
+
+  if (!conf_data.ret) {
+    GST_INFO_OBJECT (self, "Annex-B not supported, converting to AVC");
+    conf_data.description =
+        gst_web_codecs_h264_make_avcc (sps, sps_size, pps, pps_size);
+    if (conf_data.description) {
+      gst_web_runner_send_message (
+          runner, gst_web_codecs_video_decoder_configure, &conf_data);
+      gst_buffer_unref (conf_data.description);
+    }
+    self->annexb_to_avc = conf_data.ret;
+  }
+  gst_object_unref (runner);
+  GST_VIDEO_DECODER_STREAM_LOCK (self);
+
+  if (!conf_data.ret) {
+    gst_buffer_unmap (frame->input_buffer, &map);
+    GST_ELEMENT_ERROR (self, STREAM, CODEC_NOT_FOUND, (NULL),
+        ("Codec %s is not supported", mime_codec));
+    g_free (mime_codec);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  /* Keep them to find out changes, they can point to the previous ones */
+  if (!self->sps || sps != g_bytes_get_data (self->sps, NULL)) {
+    g_clear_pointer (&self->sps, g_bytes_unref);
+    g_clear_pointer (&self->pps, g_bytes_unref);
+    self->sps = g_bytes_new (sps, sps_size);
+    self->pps = g_bytes_new (pps, pps_size);
+  }
+  gst_buffer_unmap (frame->input_buffer, &map);
+
+  GST_INFO_OBJECT (self, "Configured from in-band SPS/PPS for codec %s",
+      mime_codec);
+  g_free (mime_codec);
+  self->configured = TRUE;
+
+  return GST_FLOW_OK;
+}
+
+/* Configures the decoder created after an error from the caps, called with
+ * the streaming lock taken
+ */
+static GstFlowReturn
+gst_web_codecs_video_decoder_reconfigure (GstWebCodecsVideoDecoder *self)
+{
+  GstWebCodecsVideoDecoderConfigureData conf_data;
+  GstWebRunner *runner;
+
+  GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+  runner = (GstWebRunner *) gst_object_ref (self->runner);
+  conf_data.self = self;
+  conf_data.codec = self->codec;
+  conf_data.description = self->codec_data;
+  gst_web_runner_send_message (
+      runner, gst_web_codecs_video_decoder_configure, &conf_data);
+  gst_object_unref (runner);
+  GST_VIDEO_DECODER_STREAM_LOCK (self);
+
+  if (!conf_data.ret) {
+    GST_ELEMENT_ERROR (self, STREAM, CODEC_NOT_FOUND, (NULL),
+        ("Codec %s is not supported", self->codec));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  GST_INFO_OBJECT (self, "Reconfigured for codec %s", self->codec);
+  self->configured = TRUE;
+
+  return GST_FLOW_OK;
 }
 
+static void
+gst_web_codecs_video_decoder_dtor (gpointer data)
+{
+  GstWebCodecsVideoDecoder *self = GST_WEB_CODECS_VIDEO_DECODER (data);
+
+  if (!self->has_decoder)
+    return;
+
+  if (self->decoder["state"].as<std::string> () != "closed")
+    self->decoder.call<void> ("close");
+  self->decoder = val::undefined ();
+  self->has_decoder = FALSE;
+  GST_DEBUG_OBJECT (self, "decoder closed");
+}
+
+/* Drops whatever is being decoded. reset() leaves the decoder unconfigured,
+ * nothing submitted is in flight anymore
+ */
+static void
+gst_web_codecs_video_decoder_reset (gpointer data)
+{
+  GstWebCodecsVideoDecoder *self = GST_WEB_CODECS_VIDEO_DECODER (data);
+
+  self->in_flight = 0;
+  if (!self->has_decoder ||
+      self->decoder["state"].as<std::string> () != "configured")
+    return;
+
+  self->decoder.call<void> ("reset");
+  GST_DEBUG_OBJECT (self, "decoder reset");
+}
+
+/* Creates the decoder, unless there is one that can be reconfigured. The
+ * browser closes the decoder on errors, a new one is needed then
+ */
 static void
 gst_web_codecs_video_decoder_ctor (gpointer data)
 {
@@ -347,6 +1102,16 @@ gst_web_codecs_video_decoder_ctor (gpointer data)
   val mod = val::global ("Module");
   val options = val::object ();
 
+  if (self->has_decoder &&
+      self->decoder["state"].as<std::string> () != "closed") {
+    /* A configure() must be followed by a keyframe */
+    if (self->decoder["state"].as<std::string> () == "configured")
+      self->skip_to_keyframe = TRUE;
+    GST_DEBUG_OBJECT (self, "reusing the decoder");
+    return;
+  }
+  gst_web_codecs_video_decoder_dtor (self);
+
   /* clang-format off */
   EM_ASM ({
     const self = $0;
@@ -361,6 +1126,7 @@ gst_web_codecs_video_decoder_ctor (gpointer data)
   /* clang-format on */
 
   self->decoder = vdecclass.new_ (options);
+  self->has_decoder = TRUE;
 
   /* clang-format off */
   EM_ASM ({
@@ -376,6 +1142,144 @@ gst_web_codecs_video_decoder_ctor (gpointer data)
   GST_DEBUG_OBJECT (self, "decoder created successfully");
 }
 
+static void
+gst_web_codecs_video_decoder_release_runner (GstWebCodecsVideoDecoder *self)
+{
+  if (!self->runner)
+    return;
+
+  if (self->pooled_runner)
+    gst_web_codecs_runner_pool_release (self->runner);
+  else
+    gst_object_unref (self->runner);
+  self->runner = NULL;
+  self->pooled_runner = FALSE;
+}
+
+/* Moves the decoder to the GL thread when downstream prefers GL memory, the
+ * VideoFrames must be created there to upload them into textures. Called
+ * before creating the JS decoder
+ */
+static gboolean
+gst_web_codecs_video_decoder_ensure_gl (GstWebCodecsVideoDecoder *self)
+{
+  GstCaps *peer_caps;
+  GstCapsFeatures *features;
+  GError *error = NULL;
+  gboolean want_gl = FALSE;
+
+  if (self->gl)
+    return TRUE;
+
+  peer_caps = gst_pad_peer_query_caps (GST_VIDEO_DECODER_SRC_PAD (self), NULL);
+  if (!gst_caps_is_any (peer_caps) && !gst_caps_is_empty (peer_caps)) {
+    features = gst_caps_get_features (peer_caps, 0);
+    want_gl = features && gst_caps_features_contains (
+                              features, GST_CAPS_FEATURE_MEMORY_GL_MEMORY);
+  }
+  gst_caps_unref (peer_caps);
+  if (!want_gl)
+    return TRUE;
+
+  if (!gst_gl_ensure_element_data (
+          GST_ELEMENT (self), &self->gl_display, &self->other_gl_context))
+    return FALSE;
+
+  if (!gst_gl_query_local_gl_context (
+          GST_ELEMENT (self), GST_PAD_SRC, &self->gl_context)) {
+    GST_OBJECT_LOCK (self->gl_display);
+    do {
+      gst_clear_object (&self->gl_context);
+      self->gl_context =
+          gst_gl_display_get_gl_context_for_thread (self->gl_display, NULL);
+      if (!self->gl_context &&
+          !gst_gl_display_create_context (self->gl_display,
+              self->other_gl_context, &self->gl_context, &error)) {
+        GST_OBJECT_UNLOCK (self->gl_display);
+        GST_ELEMENT_ERROR (self, RESOURCE, NOT_FOUND, ("%s", error->message),
+            (NULL));
+        g_clear_error (&error);
+        return FALSE;
+      }
+    } while (!gst_gl_display_add_context (self->gl_display, self->gl_context));
+    GST_OBJECT_UNLOCK (self->gl_display);
+  }
+
+  GST_INFO_OBJECT (self, "Decoding into textures of %" GST_PTR_FORMAT,
+      self->gl_context);
+  /* A decoder from previous caps lives on the old runner, its pending
+   * outputs take the streaming lock there
+   */
+  if (self->runner) {
+    GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+    gst_web_runner_send_message (
+        self->runner, gst_web_codecs_video_decoder_dtor, self);
+    GST_VIDEO_DECODER_STREAM_LOCK (self);
+  }
+  gst_web_codecs_video_decoder_release_runner (self);
+  self->runner = gst_web_gl_runner_new (self->gl_context);
+  self->gl = TRUE;
+
+  return TRUE;
+}
+
+static gboolean
+gst_web_codecs_video_decoder_decide_allocation (
+    GstVideoDecoder *decoder, GstQuery *query)
+{
+  GstWebCodecsVideoDecoder *self = GST_WEB_CODECS_VIDEO_DECODER (decoder);
+  GstBufferPool *pool = NULL;
+  GstStructure *config;
+  GstVideoInfo info;
+  GstCaps *caps;
+  guint size, min = 0, max = 0;
+  gboolean update_pool;
+
+  if (!self->gl) {
+    return GST_VIDEO_DECODER_CLASS (parent_class)->decide_allocation (
+        decoder, query);
+  }
+
+  gst_query_parse_allocation (query, &caps, NULL);
+  if (!caps || !gst_video_info_from_caps (&info, caps)) {
+    GST_ERROR_OBJECT (self, "Invalid allocation caps %" GST_PTR_FORMAT, caps);
+    return FALSE;
+  }
+
+  size = info.size;
+  update_pool = gst_query_get_n_allocation_pools (query) > 0;
+  if (update_pool) {
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+    if (pool && !GST_IS_GL_BUFFER_POOL (pool))
+      gst_clear_object (&pool);
+  }
+  if (!pool)
+    pool = gst_gl_buffer_pool_new (self->gl_context);
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, size, min, max);
+  gst_buffer_pool_config_add_option (
+      config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+  if (gst_query_find_allocation_meta (
+          query, GST_GL_SYNC_META_API_TYPE, NULL)) {
+    gst_buffer_pool_config_add_option (
+        config, GST_BUFFER_POOL_OPTION_GL_SYNC_META);
+  }
+  if (!gst_buffer_pool_set_config (pool, config)) {
+    GST_ERROR_OBJECT (self, "Impossible to configure the GL pool");
+    gst_object_unref (pool);
+    return FALSE;
+  }
+
+  if (update_pool)
+    gst_query_set_nth_allocation_pool (query, 0, pool, size, min, max);
+  else
+    gst_query_add_allocation_pool (query, pool, size, min, max);
+  gst_object_unref (pool);
+
+  return TRUE;
+}
+
 /* Called with the streaming lock taken */
 static gboolean
 gst_web_codecs_video_decoder_negotiate (GstVideoDecoder *decoder)
@@ -393,19 +1297,79 @@ gst_web_codecs_video_decoder_negotiate (GstVideoDecoder *decoder)
     self->output_state = NULL;
   }
 
-  self->output_state = gst_video_decoder_set_output_state (
-      decoder, self->format, self->width, self->height, self->input_state);
+  /* The textures are always RGBA, whatever the VideoFrame format is */
+  self->output_state = gst_video_decoder_set_output_state (decoder,
+      self->gl ? GST_VIDEO_FORMAT_RGBA : self->format, self->width,
+      self->height, self->input_state);
 
-  /* FIXME this depends on the downstream negotiation */
   /* Set the memory type */
   self->output_state->caps =
       gst_video_info_to_caps (&self->output_state->info);
-  gst_caps_set_features_simple (self->output_state->caps,
-      gst_caps_features_new (
-          GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME, (char *) NULL));
+  if (self->gl) {
+    gst_caps_set_features_simple (self->output_state->caps,
+        gst_caps_features_new (
+            GST_CAPS_FEATURE_MEMORY_GL_MEMORY, (char *) NULL));
+    gst_caps_set_simple (self->output_state->caps, "texture-target",
+        G_TYPE_STRING, GST_GL_TEXTURE_TARGET_2D_STR, NULL);
+  } else if (!self->system_memory) {
+    gst_caps_set_features_simple (self->output_state->caps,
+        gst_caps_features_new (
+            GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME, (char *) NULL));
+  }
   return GST_VIDEO_DECODER_CLASS (parent_class)->negotiate (decoder);
 }
 
+/* Called with the streaming lock taken. Following the QoS events, a late
+ * non-reference frame is skipped alone, a frame later than the keyframe
+ * threshold makes every delta frame be skipped until the next keyframe as
+ * the following frames depend on it
+ */
+static gboolean
+gst_web_codecs_video_decoder_qos_skip (
+    GstWebCodecsVideoDecoder *self, GstVideoCodecFrame *frame)
+{
+  GstClockTimeDiff deadline;
+  GstMapInfo map;
+  gboolean reference = TRUE;
+
+  if (GST_VIDEO_CODEC_FRAME_IS_SYNC_POINT (frame)) {
+    if (self->qos_skip_to_keyframe)
+      GST_INFO_OBJECT (self, "Keyframe reached, resuming decoding");
+    self->qos_skip_to_keyframe = FALSE;
+    return FALSE;
+  }
+
+  if (self->qos_skip_to_keyframe)
+    return TRUE;
+
+  deadline = gst_video_decoder_get_max_decode_time (
+      GST_VIDEO_DECODER (self), frame);
+  if (deadline >= 0)
+    return FALSE;
+
+  if (deadline < -GST_WEB_CODECS_VIDEO_DECODER_QOS_KEYFRAME_THRESHOLD) {
+    GST_INFO_OBJECT (self,
+        "Late by %" GST_STIME_FORMAT ", skipping until the next keyframe",
+        GST_STIME_ARGS (-deadline));
+    self->qos_skip_to_keyframe = TRUE;
+    return TRUE;
+  }
+
+  if (self->h264 && gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ)) {
+    reference = gst_web_codecs_h264_is_reference (
+        map.data, map.size, self->nal_length_size);
+    gst_buffer_unmap (frame->input_buffer, &map);
+  }
+
+  if (!reference) {
+    GST_DEBUG_OBJECT (self,
+        "Late by %" GST_STIME_FORMAT ", skipping non-reference frame",
+        GST_STIME_ARGS (-deadline));
+  }
+
+  return !reference;
+}
+
 static GstFlowReturn
 gst_web_codecs_video_decoder_handle_frame (
     GstVideoDecoder *decoder, GstVideoCodecFrame *frame)
@@ -414,10 +1378,85 @@ gst_web_codecs_video_decoder_handle_frame (
   GstWebCodecsVideoDecoderDecodeData *decode_data;
   GstWebRunner *runner;
   GstFlowReturn res = GST_FLOW_OK;
+  gint generation;
 
   GST_DEBUG_OBJECT (decoder, "Handling frame");
+  if (self->failed) {
+    gst_video_decoder_release_frame (decoder, frame);
+    return GST_FLOW_ERROR;
+  }
+
+  /* Only the keyframes are shown in a key units trick mode, do not decode
+   * the rest
+   */
+  if (decoder->input_segment.flags & GST_SEGMENT_FLAG_TRICKMODE_KEY_UNITS &&
+      !GST_VIDEO_CODEC_FRAME_IS_SYNC_POINT (frame)) {
+    GST_LOG_OBJECT (self, "Skipping delta frame in key units trick mode");
+    gst_video_decoder_release_frame (decoder, frame);
+    return GST_FLOW_OK;
+  }
+
+  /* A byte-stream can change its SPS on the fly, configure again from the
+   * keyframe that carries the new one
+   */
+  if (self->annexb && self->configured &&
+      GST_VIDEO_CODEC_FRAME_IS_SYNC_POINT (frame) &&
+      gst_web_codecs_video_decoder_sps_changed (self, frame)) {
+    GST_INFO_OBJECT (self, "In-band SPS changed, reconfiguring");
+    self->configured = FALSE;
+  }
+
+  /* Not configured yet for a byte-stream or not anymore after an error,
+   * either way we can only start from a keyframe
+   */
+  if (!self->configured) {
+    if (!GST_VIDEO_CODEC_FRAME_IS_SYNC_POINT (frame)) {
+      GST_DEBUG_OBJECT (self, "Waiting for a keyframe to configure");
+      g_mutex_lock (&self->stats_lock);
+      self->dropped++;
+      g_mutex_unlock (&self->stats_lock);
+      return gst_video_decoder_drop_frame (decoder, frame);
+    }
+    if (self->annexb)
+      res = gst_web_codecs_video_decoder_configure_annexb (self, frame);
+    else
+      res = gst_web_codecs_video_decoder_reconfigure (self);
+    if (res != GST_FLOW_OK) {
+      gst_video_decoder_release_frame (decoder, frame);
+      return res;
+    }
+    if (!self->configured) {
+      g_mutex_lock (&self->stats_lock);
+      self->dropped++;
+      g_mutex_unlock (&self->stats_lock);
+      return gst_video_decoder_drop_frame (decoder, frame);
+    }
+  }
+
+  /* The browser rejects delta frames after a configure() */
+  if (self->skip_to_keyframe) {
+    if (!GST_VIDEO_CODEC_FRAME_IS_SYNC_POINT (frame)) {
+      GST_DEBUG_OBJECT (self, "Waiting for a keyframe, dropping frame");
+      g_mutex_lock (&self->stats_lock);
+      self->dropped++;
+      g_mutex_unlock (&self->stats_lock);
+      return gst_video_decoder_drop_frame (decoder, frame);
+    }
+    self->skip_to_keyframe = FALSE;
+  }
+
+  /* Do not waste decoding time on what will be dropped anyway */
+  if (gst_web_codecs_video_decoder_qos_skip (self, frame)) {
+    g_mutex_lock (&self->stats_lock);
+    self->skipped++;
+    self->dropped++;
+    g_mutex_unlock (&self->stats_lock);
+    return gst_video_decoder_drop_frame (decoder, frame);
+  }
+
   /* Wait until there is nothing pending to be to dequeued or there is a buffer
    */
+  generation = g_atomic_int_get (&self->generation);
   GST_VIDEO_DECODER_STREAM_UNLOCK (self);
   g_mutex_lock (&self->dequeue_lock);
   while (self->dequeue_size >= GST_WEB_CODECS_VIDEO_DECODER_MAX_DEQUEUE) {
@@ -429,15 +1468,23 @@ gst_web_codecs_video_decoder_handle_frame (
   g_mutex_unlock (&self->dequeue_lock);
   GST_VIDEO_DECODER_STREAM_LOCK (self);
 
+  /* An error or a flush meanwhile released the frame */
+  if (generation != g_atomic_int_get (&self->generation)) {
+    GST_DEBUG_OBJECT (self, "Frame released while waiting, skipping it");
+    gst_video_codec_frame_unref (frame);
+    return GST_FLOW_OK;
+  }
+
   /* We are ready to process data */
   GST_DEBUG_OBJECT (self, "Ready to process more data");
   decode_data = g_new (GstWebCodecsVideoDecoderDecodeData, 1);
   decode_data->self = self;
   decode_data->frame = frame;
+  decode_data->generation = generation;
   /* We can not keep the stream lock taken here and when the decoder outputs
    * frames, do it asynchronous
    */
-  runner = gst_web_canvas_get_runner (self->canvas);
+  runner = (GstWebRunner *) gst_object_ref (self->runner);
   gst_web_runner_send_message_async (
       runner, gst_web_codecs_video_decoder_decode, decode_data, g_free);
   gst_object_unref (runner);
@@ -454,50 +1501,86 @@ gst_web_codecs_video_decoder_set_format (
   GstWebCodecsVideoDecoder *self = GST_WEB_CODECS_VIDEO_DECODER (decoder);
   GstWebCodecsVideoDecoderConfigureData conf_data;
   GstWebRunner *runner;
+  GstStructure *s;
+  const GValue *codec_data_value;
+  gchar *mime_codec;
+  gboolean ret = TRUE;
 
   GST_INFO_OBJECT (
       self, "Setting format with sink caps %" GST_PTR_FORMAT, state->caps);
-#if 0
-  /* If the output format IS GL, we need to request the context
-   * and do everything on the GL context thread, otherwise create
-   * our own thread. This is a limitation on how Emscripten works
-   * tegarding emscripten::val and threads. The vals are not shared
-   * among threads, are local.
-   * We have an open issue for this case:
-   * https://github.com/emscripten-core/emscripten/issues/22541
-   *
-   * In any case we'll have a situation, the video_frame belongs to the WebRunner
-   * transferring the image to a GLTexture requires that both, the GL thread and the
-   * WebRunner thread share the js video_frame ... we'll figure that out later.
-   * There are several options to handle this
-   */
 
-  if (!gst_web_runner_run (self->runner, NULL)) {
-    GST_ERROR_OBJECT (self, "Impossible to run the runner");
+  s = gst_caps_get_structure (state->caps, 0);
+  codec_data_value = gst_structure_get_value (s, "codec_data");
+  self->annexb = gst_structure_has_name (s, "video/x-h264") &&
+                 !g_strcmp0 (gst_structure_get_string (s, "stream-format"),
+                     "byte-stream");
+  self->annexb_to_avc = FALSE;
+  self->configured = FALSE;
+  g_clear_pointer (&self->sps, g_bytes_unref);
+  g_clear_pointer (&self->pps, g_bytes_unref);
+  gst_web_codecs_video_decoder_reset_latency (self);
+  self->h264 = gst_structure_has_name (s, "video/x-h264");
+  self->nal_length_size = 0;
+  if (!self->annexb && !codec_data_value && self->h264) {
+    GST_ERROR_OBJECT (self, "Caps do not have codec_data");
     return FALSE;
   }
-#endif
-  /* TODO Check if downstream OpenGL is supported, if so, request the GL
-   * context */
+  if (!self->annexb && self->h264) {
+    GstBuffer *avcc = gst_value_get_buffer (codec_data_value);
+    guint8 length_size_minus_one;
 
-  /* Call constructor */
-  runner = gst_web_canvas_get_runner (self->canvas);
-  gst_web_runner_send_message (
-      runner, gst_web_codecs_video_decoder_ctor, self);
-  /* Configure */
-  conf_data.self = self;
-  conf_data.state = state;
-  gst_web_runner_send_message (
-      runner, gst_web_codecs_video_decoder_configure, &conf_data);
+    /* lengthSizeMinusOne is in the 5th byte of the avcC */
+    if (gst_buffer_extract (avcc, 4, &length_size_minus_one, 1) == 1)
+      self->nal_length_size = (length_size_minus_one & 0x3) + 1;
+  }
+  /* The vals are local to the thread that created them, when the output is
+   * GL the decoder must live on the GL thread to upload its VideoFrames
+   */
+  if (!gst_web_codecs_video_decoder_ensure_gl (self)) {
+    GST_ERROR_OBJECT (self, "Impossible to get a GL context");
+    return FALSE;
+  }
 
-  /* Keep the input state available */
+  /* Keep the input state available, the configuration depends on it */
   if (self->input_state)
     gst_video_codec_state_unref (self->input_state);
   self->input_state = gst_video_codec_state_ref (state);
 
+  if (!self->annexb) {
+    mime_codec = gst_codec_utils_caps_get_mime_codec (state->caps);
+    if (!mime_codec) {
+      GST_ERROR_OBJECT (self, "Impossible to get the codec string");
+      return FALSE;
+    }
+    g_free (self->codec);
+    self->codec = mime_codec;
+    gst_buffer_replace (&self->codec_data,
+        codec_data_value ? gst_value_get_buffer (codec_data_value) : NULL);
+  }
+
+  /* The frames decoded with the previous caps are output with the
+   * streaming lock taken on the runner
+   */
+  GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+  /* Call constructor, the decoder of previous caps is reused */
+  runner = (GstWebRunner *) gst_object_ref (self->runner);
+  gst_web_runner_send_message (
+      runner, gst_web_codecs_video_decoder_ctor, self);
+  /* Configure, a byte-stream is configured from the first keyframe */
+  if (!self->annexb) {
+    conf_data.self = self;
+    conf_data.codec = self->codec;
+    conf_data.description = self->codec_data;
+    gst_web_runner_send_message (
+        runner, gst_web_codecs_video_decoder_configure, &conf_data);
+    ret = conf_data.ret;
+  }
   gst_object_unref (runner);
+  GST_VIDEO_DECODER_STREAM_LOCK (self);
+  if (!self->annexb)
+    self->configured = ret;
 
-  return TRUE;
+  return ret;
 }
 
 static gboolean
@@ -506,7 +1589,27 @@ gst_web_codecs_video_decoder_flush (GstVideoDecoder *decoder)
   GstWebCodecsVideoDecoder *self = GST_WEB_CODECS_VIDEO_DECODER (decoder);
 
   GST_DEBUG_OBJECT (self, "Flushing");
-  /* TODO Call flush */
+  self->skip_to_keyframe = FALSE;
+  self->qos_skip_to_keyframe = FALSE;
+  if (self->runner) {
+    /* The outputs take the streaming lock on the runner */
+    GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+    gst_web_runner_send_message (
+        self->runner, gst_web_codecs_video_decoder_reset, self);
+    GST_VIDEO_DECODER_STREAM_LOCK (self);
+    /* Configured again from the next keyframe */
+    self->configured = FALSE;
+    g_atomic_int_inc (&self->generation);
+  }
+  gst_web_codecs_video_decoder_drop_copies (self);
+  gst_web_codecs_video_decoder_reset_latency (self);
+  /* The chunks submitted before are not output anymore */
+  gst_web_codecs_stats_flush (&self->stats);
+
+  g_mutex_lock (&self->dequeue_lock);
+  self->dequeue_size = 0;
+  g_cond_signal (&self->dequeue_cond);
+  g_mutex_unlock (&self->dequeue_lock);
   GST_DEBUG_OBJECT (self, "Flushed");
 
   return TRUE;
@@ -534,20 +1637,51 @@ static gboolean
 gst_web_codecs_video_decoder_start (GstVideoDecoder *decoder)
 {
   GstWebCodecsVideoDecoder *self = GST_WEB_CODECS_VIDEO_DECODER (decoder);
+  GstWebCodecsRunnerMode runner_mode;
   GstWebRunner *runner;
   gboolean ret = FALSE;
 
   GST_DEBUG_OBJECT (self, "Start");
-  runner = gst_web_canvas_get_runner (self->canvas);
+  GST_OBJECT_LOCK (self);
+  runner_mode = self->runner_mode;
+  GST_OBJECT_UNLOCK (self);
+  /* Decoding off the canvas runner only pays when nothing imports the
+   * VideoFrames, as when they are copied to system memory
+   */
+  if (runner_mode == GST_WEB_CODECS_RUNNER_MODE_AUTO) {
+    runner_mode = gst_web_codecs_video_decoder_get_copy_format (self)
+                      ? GST_WEB_CODECS_RUNNER_MODE_POOL
+                      : GST_WEB_CODECS_RUNNER_MODE_SHARED;
+    GST_INFO_OBJECT (self, "Using the %s runner",
+        runner_mode == GST_WEB_CODECS_RUNNER_MODE_POOL ? "pool" : "shared");
+  }
+  switch (runner_mode) {
+    case GST_WEB_CODECS_RUNNER_MODE_DEDICATED:
+      runner = gst_web_runner_new (NULL);
+      break;
+    case GST_WEB_CODECS_RUNNER_MODE_POOL:
+      runner = gst_web_codecs_runner_pool_acquire ();
+      break;
+    case GST_WEB_CODECS_RUNNER_MODE_SHARED:
+    default:
+      runner = gst_web_canvas_get_runner (self->canvas);
+      break;
+  }
   if (!gst_web_runner_run (runner, NULL)) {
     GST_ERROR_OBJECT (self, "Impossible to run the runner");
+    if (runner_mode == GST_WEB_CODECS_RUNNER_MODE_POOL)
+      gst_web_codecs_runner_pool_release (runner);
+    else
+      gst_object_unref (runner);
     goto done;
   }
   GST_DEBUG_OBJECT (self, "Started");
+  g_warn_if_fail (self->runner == NULL);
+  self->runner = runner;
+  self->pooled_runner = runner_mode == GST_WEB_CODECS_RUNNER_MODE_POOL;
   ret = TRUE;
 
 done:
-  gst_object_unref (runner);
   return ret;
 }
 
@@ -558,6 +1692,45 @@ gst_web_codecs_video_decoder_stop (GstVideoDecoder *decoder)
 
   GST_DEBUG_OBJECT (self, "Stop");
   /* TODO Call reset */
+  self->annexb = FALSE;
+  self->annexb_to_avc = FALSE;
+  self->configured = FALSE;
+  g_clear_pointer (&self->sps, g_bytes_unref);
+  g_clear_pointer (&self->pps, g_bytes_unref);
+  self->in_flight = 0;
+  gst_web_codecs_video_decoder_reset_latency (self);
+  self->failed = FALSE;
+  self->error_time = 0;
+  self->h264 = FALSE;
+  self->nal_length_size = 0;
+  self->skip_to_keyframe = FALSE;
+  self->qos_skip_to_keyframe = FALSE;
+  g_mutex_lock (&self->stats_lock);
+  self->software_fallback = FALSE;
+  self->failovers = 0;
+  self->last_downtime = 0;
+  self->total_downtime = 0;
+  self->skipped = 0;
+  self->dropped = 0;
+  g_mutex_unlock (&self->stats_lock);
+  gst_web_codecs_stats_reset (&self->stats);
+  g_free (self->codec);
+  self->codec = NULL;
+  GST_VIDEO_DECODER_STREAM_LOCK (self);
+  gst_web_codecs_video_decoder_drop_copies (self);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+  gst_buffer_replace (&self->codec_data, NULL);
+
+  if (self->runner) {
+    gst_web_runner_send_message (
+        self->runner, gst_web_codecs_video_decoder_dtor, self);
+  }
+  gst_web_codecs_video_decoder_release_runner (self);
+  self->gl = FALSE;
+  self->system_memory = FALSE;
+  gst_clear_object (&self->gl_context);
+  gst_clear_object (&self->other_gl_context);
+  gst_clear_object (&self->gl_display);
 
   if (self->output_format) {
     g_free (self->output_format);
@@ -585,6 +1758,8 @@ gst_web_codecs_video_decoder_set_context (
 {
   GstWebCodecsVideoDecoder *self = GST_WEB_CODECS_VIDEO_DECODER (element);
 
+  gst_gl_handle_set_context (
+      element, context, &self->gl_display, &self->other_gl_context);
   gst_web_utils_element_set_context (element, context, &self->canvas);
 }
 
@@ -598,6 +1773,10 @@ gst_web_codecs_video_decoder_query (GstElement *element, GstQuery *query)
     case GST_QUERY_CONTEXT:
       ret = gst_web_utils_element_handle_context_query (
           element, query, self->canvas);
+      if (!ret) {
+        ret = gst_gl_handle_context_query (element, query, self->gl_display,
+            self->gl_context, self->other_gl_context);
+      }
       break;
     default:
       break;
@@ -609,6 +1788,67 @@ gst_web_codecs_video_decoder_query (GstElement *element, GstQuery *query)
   return ret;
 }
 
+static void
+gst_web_codecs_video_decoder_set_property (
+    GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  GstWebCodecsVideoDecoder *self = GST_WEB_CODECS_VIDEO_DECODER (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_LOW_LATENCY:
+      self->low_latency = g_value_get_boolean (value);
+      break;
+    case PROP_HARDWARE_ACCELERATION:
+      self->hardware_acceleration =
+          (GstWebCodecsHardwareAcceleration) g_value_get_enum (value);
+      break;
+    case PROP_RUNNER_MODE:
+      self->runner_mode = (GstWebCodecsRunnerMode) g_value_get_enum (value);
+      break;
+    case PROP_STATS_INTERVAL:
+      self->stats_interval = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gst_web_codecs_video_decoder_get_property (
+    GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  GstWebCodecsVideoDecoder *self = GST_WEB_CODECS_VIDEO_DECODER (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_LOW_LATENCY:
+      g_value_set_boolean (value, self->low_latency);
+      break;
+    case PROP_HARDWARE_ACCELERATION:
+      g_value_set_enum (value, self->hardware_acceleration);
+      break;
+    case PROP_RUNNER_MODE:
+      g_value_set_enum (value, self->runner_mode);
+      break;
+    case PROP_STATS_INTERVAL:
+      g_value_set_uint (value, self->stats_interval);
+      break;
+    case PROP_STATS:
+      /* Stats are protected by the streaming lock */
+      GST_OBJECT_UNLOCK (self);
+      g_value_take_boxed (
+          value, gst_web_codecs_video_decoder_create_stats (self));
+      return;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
 static void
 gst_web_codecs_video_decoder_finalize (GObject *object)
 {
@@ -616,6 +1856,8 @@ gst_web_codecs_video_decoder_finalize (GObject *object)
 
   g_mutex_clear (&self->dequeue_lock);
   g_cond_clear (&self->dequeue_cond);
+  g_mutex_clear (&self->stats_lock);
+  gst_web_codecs_stats_clear (&self->stats);
   if (self->canvas) {
     gst_object_unref (self->canvas);
     self->canvas = NULL;
@@ -630,8 +1872,15 @@ gst_web_codecs_video_decoder_init (
     GstWebCodecsVideoDecoder *self, GstWebCodecsVideoDecoderClass g_class)
 {
   gst_video_decoder_set_needs_sync_point (GST_VIDEO_DECODER (self), TRUE);
+  self->low_latency = DEFAULT_LOW_LATENCY;
+  self->hardware_acceleration = DEFAULT_HARDWARE_ACCELERATION;
+  self->runner_mode = DEFAULT_RUNNER_MODE;
+  self->stats_interval = DEFAULT_STATS_INTERVAL;
+  gst_web_codecs_stats_init (&self->stats);
+  g_mutex_init (&self->stats_lock);
   g_mutex_init (&self->dequeue_lock);
   g_cond_init (&self->dequeue_cond);
+  g_queue_init (&self->copies);
 }
 
 static void
@@ -686,7 +1935,49 @@ gst_web_codecs_video_decoder_class_init (
   GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
   GstVideoDecoderClass *video_decoder_class = GST_VIDEO_DECODER_CLASS (klass);
 
+  gobject_class->set_property = gst_web_codecs_video_decoder_set_property;
+  gobject_class->get_property = gst_web_codecs_video_decoder_get_property;
   gobject_class->finalize = gst_web_codecs_video_decoder_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_LOW_LATENCY,
+      g_param_spec_boolean ("low-latency", "Low latency",
+          "Output frames as soon as possible instead of waiting for the "
+          "reorder window (optimizeForLatency)",
+          DEFAULT_LOW_LATENCY,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+                         G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_HARDWARE_ACCELERATION,
+      g_param_spec_enum ("hardware-acceleration", "Hardware acceleration",
+          "Hardware acceleration preference of the decoder",
+          GST_TYPE_WEB_CODECS_HARDWARE_ACCELERATION,
+          DEFAULT_HARDWARE_ACCELERATION,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+                         G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_RUNNER_MODE,
+      g_param_spec_enum ("runner-mode", "Runner mode",
+          "Thread where the WebCodecs calls happen. Frames decoded on a "
+          "different runner than the sink one are copied to it, auto "
+          "avoids it",
+          GST_TYPE_WEB_CODECS_RUNNER_MODE, DEFAULT_RUNNER_MODE,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+                         G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Decoder statistics: failovers to software, the time spent "
+          "recovering (total and last) in nanoseconds, the frames "
+          "skipped by QoS before decoding and dropped, the chunks "
+          "submitted, the frames output, the errors, the decode latency "
+          "percentiles in nanoseconds, the histogram of the queue depths "
+          "and the hardware acceleration in use",
+          GST_TYPE_STRUCTURE,
+          (GParamFlags) (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_STATS_INTERVAL,
+      g_param_spec_uint ("stats-interval", "Statistics interval",
+          "Milliseconds between the webcodecs-stats element messages with "
+          "the content of the stats property, 0 to disable them",
+          0, G_MAXUINT, DEFAULT_STATS_INTERVAL,
+          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
   element_class->set_context = gst_web_codecs_video_decoder_set_context;
   element_class->query = gst_web_codecs_video_decoder_query;
   gst_element_class_set_static_metadata (element_class,
@@ -708,6 +1999,8 @@ gst_web_codecs_video_decoder_class_init (
       GST_DEBUG_FUNCPTR (gst_web_codecs_video_decoder_handle_frame);
   video_decoder_class->negotiate =
       GST_DEBUG_FUNCPTR (gst_web_codecs_video_decoder_negotiate);
+  video_decoder_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_web_codecs_video_decoder_decide_allocation);
 
   parent_class = g_type_class_peek_parent (klass);
 }
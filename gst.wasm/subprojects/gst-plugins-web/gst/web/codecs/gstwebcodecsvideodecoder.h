@@ -29,11 +29,15 @@
 
 #include <gst/gst.h>
 #include <gst/video/gstvideodecoder.h>
+#include <gst/gl/gl.h>
 #include <emscripten/bind.h>
 #include <string.h>
 #include <gst/web/gstwebcanvas.h>
 #include <gst/web/gstwebrunner.h>
 
+#include "gstwebcodecs.h"
+#include "gstwebcodecsstats.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_WEB_CODECS_VIDEO_DECODER                                     \
@@ -67,11 +71,80 @@ struct _GstWebCodecsVideoDecoder
 
   /* TODO move this to a prv struct */
   GstWebCanvas *canvas;
+  /* The runner of the canvas, our own or one of the pool, the output
+   * VideoFrames belong to it */
+  GstWebRunner *runner;
+  /* The runner was taken from the pool */
+  gboolean pooled_runner;
+  /* Output in GL textures, the runner is the GL thread then */
+  gboolean gl;
+  /* Output in system memory, VideoFrames are copied and closed once done */
+  gboolean system_memory;
+  /* The copies in flight, in output order, under the streaming lock */
+  GQueue copies;
+  GstGLDisplay *gl_display;
+  GstGLContext *other_gl_context;
+  GstGLContext *gl_context;
   gint width;
   gint height;
   GstVideoFormat format;
+  /* The format of the VideoFrames, format is the negotiated one */
+  GstVideoFormat frame_format;
   gboolean need_negotiation;
+  /* Input is H.264 byte-stream, configure from the in-band SPS/PPS */
+  gboolean annexb;
+  /* The browser does not accept Annex-B, send length-prefixed NALs */
+  gboolean annexb_to_avc;
+  /* The in-band SPS/PPS the decoder is configured with */
+  GBytes *sps;
+  GBytes *pps;
+  gboolean configured;
+  /* Used to find out non-reference frames */
+  gboolean h264;
+  guint nal_length_size;
+
+  /* A reused decoder was configured again, it needs a keyframe first */
+  gboolean skip_to_keyframe;
+  /* QoS, late delta frames are not sent to the browser */
+  gboolean qos_skip_to_keyframe;
+  guint64 skipped;
+  guint64 dropped;
+
+  /* Properties */
+  gboolean low_latency;
+  GstWebCodecsHardwareAcceleration hardware_acceleration;
+  GstWebCodecsRunnerMode runner_mode;
+  guint stats_interval;
+
+  /* Chunks submitted but not yet output, updated on the runner. The
+   * frames the decoder holds are measured when nothing is queued, the
+   * reported depth is the maximum of a window of outputs */
+  gint in_flight;
+  gint latency_depth;
+  gint window_depth;
+  guint window_outputs;
+
+  /* Bumped every time the chunks submitted are lost, on errors and
+   * flushes, the decodes of a previous one are dropped. Atomic */
+  gint generation;
+
+  /* Error recovery, the configuration is kept to configure a new decoder */
+  gchar *codec;
+  GstBuffer *codec_data;
+  gboolean software_fallback;
+  gboolean failed;
+  /* Monotonic time of the error we are recovering from, 0 otherwise */
+  gint64 error_time;
+  guint failovers;
+  GstClockTime last_downtime;
+  GstClockTime total_downtime;
+
+  GstWebCodecsStats stats;
+  /* Protects the counters above read by the stats property */
+  GMutex stats_lock;
 
+  /* Whether the decoder was created, it is only touched on the runner */
+  gboolean has_decoder;
   emscripten::val decoder;
   /* Amount of the output frames pending to be dequeued */
   gint dequeue_size;
@@ -0,0 +1,127 @@
+/*
+ * GStreamer
+ * Copyright (C) 2025 Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Probes the audio codecs of the WebCodecs registry. Every codec is checked
+ * with a common configuration, the caps of the registered element are the
+ * ones the parsers of each format output
+ */
+
+typedef struct _GstWebCodecsAudioCodec
+{
+  const gchar *name;
+  const gchar *codec;
+  const gchar *caps;
+  gint rate;
+  gint channels;
+  /* Needed by the registration to check the support */
+  const guint8 *description;
+  gsize description_size;
+} GstWebCodecsAudioCodec;
+
+/* AudioSpecificConfig of AAC-LC, 48 kHz, stereo */
+static const guint8 aac_description[] = { 0x11, 0x90 };
+
+/* fLaC marker and a STREAMINFO of 48 kHz, stereo, 16 bits */
+static const guint8 flac_description[] = { 'f', 'L', 'a', 'C', 0x80, 0x00,
+  0x00, 0x22, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x0b, 0xb8, 0x02, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+/* Vorbis needs the three headers, the browsers check the codec string only.
+ * Without a description AAC is ADTS
+ */
+static const GstWebCodecsAudioCodec audio_codecs[] = {
+  { "OPUS", "opus", "audio/x-opus", 48000, 2, NULL, 0 },
+  { "AAC", "mp4a.40.2",
+      "audio/mpeg, mpegversion = (int) { 2, 4 }, stream-format = raw", 48000,
+      2, aac_description, sizeof (aac_description) },
+  { "AAC", "mp4a.40.2",
+      "audio/mpeg, mpegversion = (int) { 2, 4 }, stream-format = adts", 48000,
+      2, NULL, 0 },
+  { "MP3", "mp3",
+      "audio/mpeg, mpegversion = (int) 1, layer = (int) 3, "
+      "parsed = (boolean) true",
+      48000, 2, NULL, 0 },
+  { "FLAC", "flac", "audio/x-flac, framed = (boolean) true", 48000, 2,
+      flac_description, sizeof (flac_description) },
+  { "VORBIS", "vorbis", "audio/x-vorbis", 48000, 2, NULL, 0 },
+  { "ALAW", "alaw", "audio/x-alaw", 8000, 1, NULL, 0 },
+  { "MULAW", "ulaw", "audio/x-mulaw", 8000, 1, NULL, 0 },
+};
+
+static gboolean
+gst_web_codecs_utils_audio_codec_is_supported (
+    val adecclass, const GstWebCodecsAudioCodec *audio_codec, gboolean is_hw)
+{
+  val config = val::object ();
+
+  config.set ("codec", std::string (audio_codec->codec));
+  config.set ("sampleRate", audio_codec->rate);
+  config.set ("numberOfChannels", audio_codec->channels);
+  if (audio_codec->description) {
+    config.set ("description",
+        val (typed_memory_view (
+            audio_codec->description_size, audio_codec->description)));
+  }
+
+  return is_config_supported (
+      adecclass, config, (gchar *) audio_codec->codec, is_hw);
+}
+
+static void
+gst_web_codecs_utils_scan_audio_decoders (GstPlugin *plugin, val adecclass)
+{
+  const gchar *suffixes[] = { "SW", "HW" };
+  gint i;
+  guint j;
+
+  /* Check hw or not hw */
+  for (i = 0; i < 2; i++) {
+    GstCaps *caps = NULL;
+
+    /* The variants of a codec are consecutive and go to the same element */
+    for (j = 0; j < G_N_ELEMENTS (audio_codecs); j++) {
+      const GstWebCodecsAudioCodec *audio_codec = &audio_codecs[j];
+      gchar *codec_name;
+
+      if (gst_web_codecs_utils_audio_codec_is_supported (
+              adecclass, audio_codec, i)) {
+        if (!caps)
+          caps = gst_caps_new_empty ();
+        gst_caps_append (caps, gst_caps_from_string (audio_codec->caps));
+      } else {
+        GST_INFO ("No %s decoder found for %s", audio_codec->caps,
+            suffixes[i]);
+      }
+
+      if (j + 1 < G_N_ELEMENTS (audio_codecs) &&
+          !g_strcmp0 (audio_codecs[j + 1].name, audio_codec->name))
+        continue;
+      if (!caps)
+        continue;
+
+      codec_name = g_strdup_printf ("%s%s", audio_codec->name, suffixes[i]);
+      GST_INFO ("Audio decoder found for %s", codec_name);
+      register_audio_decoder (plugin, codec_name, gst_caps_simplify (caps), i);
+      g_free (codec_name);
+      caps = NULL;
+    }
+  }
+}
@@ -249,7 +249,11 @@ gst_web_codecs_utils_scan_video_h264_decoder (GstPlugin *plugin, val vdecclass)
     gboolean supported = FALSE;
     gint profile;
 
-    caps = gst_caps_new_empty_simple ("video/x-h264");
+    /* Without codec_data the decoder configures itself from the in-band
+     * SPS/PPS, so a byte-stream does not need to go through h264parse */
+    caps = gst_caps_from_string (
+        "video/x-h264, stream-format = (string) { avc, byte-stream }, "
+        "alignment = (string) au");
     /* Get all profiles */
     for (profile = 0; profile < GST_CODEC_UTILS_H264_PROFILES; profile++) {
       const gchar *profile_str;
@@ -0,0 +1,276 @@
+/*
+ * GStreamer - gst.wasm WebCodecs H.264 bitstream helpers
+ *
+ * Copyright 2025 Fluendo S.A.
+ * @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Minimal Annex-B helpers so the WebCodecs video decoder can consume
+ * stream-format=byte-stream directly. Only the bits needed to build a
+ * codec string and, when the browser does not accept Annex-B, an avcC
+ * description plus length-prefixed NALs are implemented here. Anything
+ * more elaborate belongs to h264parse.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "h264bitstream.h"
+
+/* Returns the offset of the first byte after the next start code, or @size
+ * if none is found
+ */
+static gsize
+gst_web_codecs_h264_next_start_code (
+    const guint8 *data, gsize size, gsize offset)
+{
+  gsize i;
+
+  for (i = offset; i + 3 <= size; i++) {
+    if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1)
+      return i + 3;
+  }
+
+  return size;
+}
+
+/* Iterates over the NALs of an Annex-B buffer. @offset must point right
+ * after a start code. Returns the NAL size, trailing zeros excluded
+ */
+static gsize
+gst_web_codecs_h264_nal_size (const guint8 *data, gsize size, gsize offset)
+{
+  gsize next;
+  gsize end;
+
+  /* Trailing zeros belong to the next 4 bytes start code */
+  next = gst_web_codecs_h264_next_start_code (data, size, offset);
+  end = next == size ? size : next - 3;
+  while (end > offset && data[end - 1] == 0)
+    end--;
+
+  return end - offset;
+}
+
+/**
+ * gst_web_codecs_h264_find_nal:
+ * @data: Annex-B data
+ * @size: size of @data
+ * @type: the nal_unit_type to look for
+ * @nal: (out): start of the NAL, header included
+ * @nal_size: (out): size of the NAL
+ *
+ * Returns: %TRUE if a NAL of @type was found
+ */
+gboolean
+gst_web_codecs_h264_find_nal (const guint8 *data, gsize size, guint8 type,
+    const guint8 **nal, gsize *nal_size)
+{
+  gsize offset;
+
+  offset = gst_web_codecs_h264_next_start_code (data, size, 0);
+  while (offset < size) {
+    gsize len = gst_web_codecs_h264_nal_size (data, size, offset);
+
+    if (len > 0 && (data[offset] & 0x1f) == type) {
+      *nal = data + offset;
+      *nal_size = len;
+      return TRUE;
+    }
+    offset = gst_web_codecs_h264_next_start_code (data, size, offset + len);
+  }
+
+  return FALSE;
+}
+
+/**
+ * gst_web_codecs_h264_get_mime_codec:
+ * @sps: a SPS NAL, header included
+ * @sps_size: size of @sps
+ *
+ * Builds the RFC 6381 codec string from the profile_idc, constraint flags and
+ * level_idc of @sps.
+ *
+ * Returns: (transfer full) (nullable): the codec string
+ */
+gchar *
+gst_web_codecs_h264_get_mime_codec (const guint8 *sps, gsize sps_size)
+{
+  if (sps_size < 4)
+    return NULL;
+
+  return g_strdup_printf ("avc1.%02X%02X%02X", sps[1], sps[2], sps[3]);
+}
+
+/**
+ * gst_web_codecs_h264_make_avcc:
+ * @sps: a SPS NAL, header included
+ * @sps_size: size of @sps
+ * @pps: a PPS NAL, header included
+ * @pps_size: size of @pps
+ *
+ * Builds an AVCDecoderConfigurationRecord with 4 bytes NAL lengths.
+ *
+ * Returns: (transfer full) (nullable): the avcC
+ */
+GstBuffer *
+gst_web_codecs_h264_make_avcc (const guint8 *sps, gsize sps_size,
+    const guint8 *pps, gsize pps_size)
+{
+  GstBuffer *avcc;
+  GstMapInfo map;
+  guint8 *p;
+
+  if (sps_size < 4 || sps_size > G_MAXUINT16 || pps_size == 0 ||
+      pps_size > G_MAXUINT16)
+    return NULL;
+
+  avcc = gst_buffer_new_allocate (NULL, 11 + sps_size + pps_size, NULL);
+  gst_buffer_map (avcc, &map, GST_MAP_WRITE);
+  p = map.data;
+  *p++ = 1;
+  *p++ = sps[1];
+  *p++ = sps[2];
+  *p++ = sps[3];
+  *p++ = 0xff;
+  *p++ = 0xe1;
+  GST_WRITE_UINT16_BE (p, sps_size);
+  p += 2;
+  memcpy (p, sps, sps_size);
+  p += sps_size;
+  *p++ = 1;
+  GST_WRITE_UINT16_BE (p, pps_size);
+  p += 2;
+  memcpy (p, pps, pps_size);
+  gst_buffer_unmap (avcc, &map);
+
+  return avcc;
+}
+
+/**
+ * gst_web_codecs_h264_annexb_to_avc:
+ * @data: Annex-B data
+ * @size: size of @data
+ * @out_size: (out): size of the returned data
+ *
+ * Replaces every start code of @data by a 4 bytes NAL length.
+ *
+ * Returns: (transfer full): the length-prefixed data, free with g_free()
+ */
+guint8 *
+gst_web_codecs_h264_annexb_to_avc (
+    const guint8 *data, gsize size, gsize *out_size)
+{
+  guint8 *out;
+  gsize offset;
+  gsize written = 0;
+
+  /* Every start code is at least 3 bytes, so in the worst case we grow one
+   * byte per NAL, and there can't be more NALs than size / 4
+   */
+  out = (guint8 *) g_malloc (size + size / 4 + 4);
+  offset = gst_web_codecs_h264_next_start_code (data, size, 0);
+  while (offset < size) {
+    gsize len = gst_web_codecs_h264_nal_size (data, size, offset);
+
+    if (len > 0) {
+      GST_WRITE_UINT32_BE (out + written, len);
+      memcpy (out + written + 4, data + offset, len);
+      written += 4 + len;
+    }
+    offset = gst_web_codecs_h264_next_start_code (data, size, offset + len);
+  }
+
+  *out_size = written;
+  return out;
+}
+
+/* nal_ref_idc of a slice NAL, or -1 for any other NAL */
+static gint
+gst_web_codecs_h264_slice_ref_idc (const guint8 *nal, gsize size)
+{
+  guint8 type;
+
+  if (size == 0)
+    return -1;
+
+  type = nal[0] & 0x1f;
+  if (type < GST_WEB_CODECS_H264_NAL_SLICE ||
+      type > GST_WEB_CODECS_H264_NAL_SLICE_IDR)
+    return -1;
+
+  return (nal[0] >> 5) & 0x3;
+}
+
+/**
+ * gst_web_codecs_h264_is_reference:
+ * @data: an access unit
+ * @size: size of @data
+ * @nal_length_size: size of the NAL lengths, 0 for Annex-B
+ *
+ * Checks whether any slice of the access unit can be referenced by other
+ * frames, that is, if dropping it breaks the decoding of the next ones.
+ *
+ * Returns: %FALSE only if every slice has a nal_ref_idc of 0
+ */
+gboolean
+gst_web_codecs_h264_is_reference (
+    const guint8 *data, gsize size, guint nal_length_size)
+{
+  gboolean found = FALSE;
+  gsize offset = 0;
+  gint ref_idc;
+
+  if (nal_length_size == 0) {
+    offset = gst_web_codecs_h264_next_start_code (data, size, 0);
+    while (offset < size) {
+      gsize len = gst_web_codecs_h264_nal_size (data, size, offset);
+
+      ref_idc = gst_web_codecs_h264_slice_ref_idc (data + offset, len);
+      if (ref_idc > 0)
+        return TRUE;
+      found |= ref_idc == 0;
+      offset = gst_web_codecs_h264_next_start_code (data, size, offset + len);
+    }
+    return !found;
+  }
+
+  while (offset + nal_length_size <= size) {
+    gsize len = 0;
+    guint i;
+
+    for (i = 0; i < nal_length_size; i++)
+      len = (len << 8) | data[offset + i];
+    offset += nal_length_size;
+    if (len > size - offset)
+      break;
+
+    ref_idc = gst_web_codecs_h264_slice_ref_idc (data + offset, len);
+    if (ref_idc > 0)
+      return TRUE;
+    found |= ref_idc == 0;
+    offset += len;
+  }
+
+  /* Without slices, better assume it is needed */
+  return !found;
+}
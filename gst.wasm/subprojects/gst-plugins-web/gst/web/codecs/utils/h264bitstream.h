@@ -0,0 +1,47 @@
+/*
+ * GStreamer - gst.wasm WebCodecs H.264 bitstream helpers
+ *
+ * Copyright 2025 Fluendo S.A.
+ * @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __GST_WEB_CODECS_H264_BITSTREAM_H__
+#define __GST_WEB_CODECS_H264_BITSTREAM_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+#define GST_WEB_CODECS_H264_NAL_SLICE 1
+#define GST_WEB_CODECS_H264_NAL_SLICE_IDR 5
+#define GST_WEB_CODECS_H264_NAL_SPS 7
+#define GST_WEB_CODECS_H264_NAL_PPS 8
+
+gboolean gst_web_codecs_h264_find_nal (const guint8 *data, gsize size,
+    guint8 type, const guint8 **nal, gsize *nal_size);
+gchar *gst_web_codecs_h264_get_mime_codec (const guint8 *sps, gsize sps_size);
+GstBuffer *gst_web_codecs_h264_make_avcc (const guint8 *sps, gsize sps_size,
+    const guint8 *pps, gsize pps_size);
+guint8 *gst_web_codecs_h264_annexb_to_avc (
+    const guint8 *data, gsize size, gsize *out_size);
+gboolean gst_web_codecs_h264_is_reference (
+    const guint8 *data, gsize size, guint nal_length_size);
+
+G_END_DECLS
+
+#endif /* __GST_WEB_CODECS_H264_BITSTREAM_H__ */
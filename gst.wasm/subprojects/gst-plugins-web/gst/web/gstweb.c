@@ -35,8 +35,10 @@
 #include "gstwebstreamsrc.h"
 #include "gstwebcanvassink.h"
 #include "gstwebcanvassrc.h"
+#include "gstwebcompositor.h"
 #include "gstwebdownload.h"
 #include "gstwebupload.h"
+#include "gstwebvideoscale.h"
 
 #include "codecs/gstwebcodecs.h"
 #include "transport/gstwebtransportsrc.h"
@@ -50,12 +52,14 @@ plugin_init (GstPlugin *plugin)
 
   gst_element_register_web_canvas_sink (plugin);
   gst_element_register_web_canvas_src (plugin);
+  gst_element_register_web_compositor (plugin);
   gst_element_register_web_em_fetch_src (plugin);
   gst_element_register_web_fetch_src (plugin);
   gst_element_register_web_stream_src (plugin);
   gst_element_register_web_transport_src (plugin);
   gst_element_register_web_download (plugin);
   gst_element_register_web_upload (plugin);
+  gst_element_register_web_video_scale (plugin);
 
   return TRUE;
 }
@@ -42,9 +42,11 @@
 #include "config.h"
 #endif
 
+#include <gst/video/gstvideopool.h>
 #include <gst/video/navigation.h>
 #include <gst/video/video.h>
 #include <gst/video/videooverlay.h>
+#include <gst/video/video-overlay-composition.h>
 #include <gst/video/video-color.h>
 #include <emscripten.h>
 #include <emscripten/bind.h>
@@ -53,6 +55,7 @@
 #include <gst/web/gstwebcanvas.h>
 #include <gst/web/gstwebutils.h>
 #include <gst/web/gstwebrunner.h>
+#include <gst/web/gstwebsimd.h>
 
 #include "gstweb.h"
 
@@ -75,6 +78,21 @@ using namespace emscripten;
 GST_DEBUG_CATEGORY_STATIC (gst_web_canvas_sink_debug_category);
 
 #define DEFAULT_CANVAS_ID "#canvas"
+#define DEFAULT_DRAW_MODE GST_WEB_CANVAS_SINK_DRAW_MODE_2D
+/* As the base class averages the QoS observations */
+#define UPDATE_RUNNING_AVG(avg, val) (((val) + (7 * (avg))) / 8)
+/* The frame being drawn, the pending one and the one upstream fills */
+#define POOL_MIN_BUFFERS 3
+#define RAW_FORMATS "{ RGBA, RGBx, BGRA, BGRx, I420, NV12 }"
+
+typedef enum
+{
+  GST_WEB_CANVAS_SINK_DRAW_MODE_2D,
+  GST_WEB_CANVAS_SINK_DRAW_MODE_BITMAP_RENDERER,
+} GstWebCanvasSinkDrawMode;
+
+#define GST_TYPE_WEB_CANVAS_SINK_DRAW_MODE                                    \
+  (gst_web_canvas_sink_draw_mode_get_type ())
 
 typedef struct _GstWebCanvasSink
 {
@@ -82,9 +100,51 @@ typedef struct _GstWebCanvasSink
   GstWebCanvas *canvas;
   gint buffer_width;
   gint buffer_height;
+  /* Known once started, the preferred size of the frames */
+  gint canvas_width;
+  gint canvas_height;
+  GstVideoInfo info;
+  /* Tightly packed RGBA, what an ImageData expects, for the raw frames in
+   * any other layout */
+  GstVideoInfo rgba_info;
+  GstBuffer *rgba_buffer;
   gchar *id;
+  GstWebCanvasSinkDrawMode draw_mode;
   val val_context;
   val val_canvas;
+  /* Reused by the raw RGBA frames of the same size */
+  val val_image_data;
+  /* Where the raw frames are scaled and the overlays are composed */
+  val val_staging;
+  val val_compose;
+  /* The ImageBitmaps of the overlay rectangles drawn, by seqnum */
+  val val_overlays;
+  /* Settled once a bitmaprenderer draw is done, for its draw time */
+  val val_drawn;
+
+  /* The newest due frame, drawn on the next animation frame of the runner */
+  GMutex present_lock;
+  struct _GstWebCanvasSinkDrawData *pending;
+  gboolean animation_frame_requested;
+  guint64 presented;
+  guint64 dropped;
+
+  /* Rendering statistics, in nanoseconds, also protected by present_lock.
+   * The lateness is the time from the frame being due to its draw */
+  GstClockTime draw_time_total;
+  GstClockTime draw_time_peak;
+  GstClockTimeDiff last_lateness;
+  gdouble jitter;
+  /* What to tell upstream on the next frame. As the base class does, the
+   * proportion is the average time between presentations, in running time,
+   * over the average frame duration */
+  gboolean qos_pending;
+  GstClockTime qos_timestamp;
+  GstClockTimeDiff qos_diff;
+  gdouble qos_proportion;
+  GstClockTime last_left;
+  GstClockTime avg_pt;
+  GstClockTime avg_duration;
 } GstWebCanvasSink;
 
 typedef struct _GstWebCanvasSinkClass
@@ -96,25 +156,48 @@ typedef struct _GstWebCanvasSinkDrawData
 {
   GstWebCanvasSink *self;
   GstBuffer *buffer;
+  /* The VideoFrame of buffer, on our runner */
+  GstWebVideoFrame *video_frame;
+  GstVideoOverlayComposition *composition;
+  GstWebRunnerCB draw;
+  /* The running time of buffer and when it was due, in monotonic time */
+  GstClockTime running_time;
+  gint64 due;
+  /* When it started being drawn, in monotonic time */
+  gint64 start;
 } GstWebCanvasSinkDrawData;
 
 typedef struct _GstWebCanvasSinkSetupData
 {
   GstWebCanvasSink *self;
+  gboolean ret;
 } GstWebCanvasSinkSetupData;
 
 enum
 {
   PROP_0,
   PROP_ID,
+  PROP_DRAW_MODE,
+  PROP_PRESENTED,
+  PROP_DROPPED,
+  PROP_STATS,
   PROP_LAST
 };
 
 static GstStaticPadTemplate static_sink_template = GST_STATIC_PAD_TEMPLATE (
     "sink", GST_PAD_SINK, GST_PAD_ALWAYS,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES (
-        GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME,
-        GST_WEB_MEMORY_VIDEO_FORMATS_STR) ";" GST_VIDEO_CAPS_MAKE ("RGBA")));
+    GST_STATIC_CAPS (
+        GST_VIDEO_CAPS_MAKE_WITH_FEATURES (
+            GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME
+            ", " GST_CAPS_FEATURE_META_GST_VIDEO_OVERLAY_COMPOSITION,
+            GST_WEB_MEMORY_VIDEO_FORMATS_STR) ";"
+        GST_VIDEO_CAPS_MAKE_WITH_FEATURES (
+            GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME,
+            GST_WEB_MEMORY_VIDEO_FORMATS_STR) ";"
+        GST_VIDEO_CAPS_MAKE_WITH_FEATURES (
+            GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY
+            ", " GST_CAPS_FEATURE_META_GST_VIDEO_OVERLAY_COMPOSITION,
+            RAW_FORMATS) ";" GST_VIDEO_CAPS_MAKE (RAW_FORMATS)));
 
 static const std::tuple<GstWebUtilsMouseCb, const char *> mouse_callbacks[] = {
   std::make_tuple (emscripten_set_click_callback_on_thread, "click"),
@@ -157,22 +240,217 @@ G_DEFINE_TYPE_WITH_CODE (
 GST_ELEMENT_REGISTER_DEFINE (web_canvas_sink, "webcanvassink",
     GST_RANK_SECONDARY, GST_TYPE_WEB_CANVAS_SINK);
 
+static GType
+gst_web_canvas_sink_draw_mode_get_type (void)
+{
+  static gsize type = 0;
+  static const GEnumValue values[] = {
+    { GST_WEB_CANVAS_SINK_DRAW_MODE_2D, "Draw with a 2d context", "2d" },
+    { GST_WEB_CANVAS_SINK_DRAW_MODE_BITMAP_RENDERER,
+        "Transfer ImageBitmaps to a bitmaprenderer context",
+        "bitmaprenderer" },
+    { 0, NULL, NULL },
+  };
+
+  if (g_once_init_enter (&type)) {
+    GType _type =
+        g_enum_register_static ("GstWebCanvasSinkDrawMode", values);
+    g_once_init_leave (&type, _type);
+  }
+  return type;
+}
+
+/* Scales @source to the canvas size into an ImageBitmap and hands it over to
+ * the bitmaprenderer context, the canvas does not copy it again. The draw
+ * is done once val_drawn settles */
+static void
+gst_web_canvas_sink_transfer_bitmap (GstWebCanvasSink *self, val &source)
+{
+  val draw = val::object ();
+
+  /* clang-format off */
+  EM_ASM ({
+    const ctx = Emval.toValue ($0);
+
+    Emval.toValue ($2).promise = createImageBitmap (Emval.toValue ($1), {
+      resizeWidth: ctx.canvas.width,
+      resizeHeight: ctx.canvas.height
+    }).then ((bitmap) => {
+      ctx.transferFromImageBitmap (bitmap);
+    });
+  }, self->val_context.as_handle (), source.as_handle (), draw.as_handle ());
+  /* clang-format on */
+  self->val_drawn = draw["promise"];
+}
+
+/* A 2d OffscreenCanvas of the given size, reused while it does not change */
+static val
+gst_web_canvas_sink_ensure_offscreen (val &canvas, gint width, gint height)
+{
+  if (canvas.isUndefined () || canvas["width"].as<int> () != width ||
+      canvas["height"].as<int> () != height) {
+    canvas = val::global ("OffscreenCanvas").new_ (width, height);
+  }
+  return canvas.call<val> ("getContext", std::string ("2d"));
+}
+
+/* The pixels of @rect in an ImageBitmap, created synchronously */
+static val
+gst_web_canvas_sink_overlay_bitmap (
+    GstWebCanvasSink *self, GstVideoOverlayRectangle *rect)
+{
+  GstVideoMeta *meta;
+  GstBuffer *pixels;
+  GstMapInfo map;
+  guint8 *rgba;
+  val image_data;
+  val canvas;
+  guint i;
+
+  /* BGRA in memory, not premultiplied. The global alpha is applied when
+   * drawing */
+  pixels = gst_video_overlay_rectangle_get_pixels_unscaled_argb (
+      rect, GST_VIDEO_OVERLAY_FORMAT_FLAG_GLOBAL_ALPHA);
+  meta = gst_buffer_get_video_meta (pixels);
+  if (!meta || !gst_buffer_map (pixels, &map, GST_MAP_READ))
+    return val::undefined ();
+
+  rgba = (guint8 *) g_malloc ((gsize) meta->width * meta->height * 4);
+  for (i = 0; i < meta->height; i++) {
+    gst_web_simd_swap_rb (map.data + meta->offset[0] + i * meta->stride[0],
+        rgba + (gsize) i * meta->width * 4, meta->width);
+  }
+  gst_buffer_unmap (pixels, &map);
+
+  image_data = val::global ("ImageData").new_ (meta->width, meta->height);
+  image_data["data"].call<void> ("set",
+      val (typed_memory_view ((gsize) meta->width * meta->height * 4, rgba)));
+  g_free (rgba);
+
+  gst_web_canvas_sink_ensure_offscreen (canvas, meta->width, meta->height)
+      .call<void> ("putImageData", image_data, 0, 0);
+  return canvas.call<val> ("transferToImageBitmap");
+}
+
+/* Draws the rectangles of @composition on @context, scaled as the frame.
+ * The ImageBitmaps of the rectangles that did not change are reused */
+static void
+gst_web_canvas_sink_draw_overlays (GstWebCanvasSink *self, val &context,
+    GstVideoOverlayComposition *composition)
+{
+  gdouble sx, sy;
+  val overlays;
+  guint i, n;
+
+  n = composition ? gst_video_overlay_composition_n_rectangles (composition)
+                  : 0;
+  if (!n && self->val_overlays.isUndefined ())
+    return;
+
+  sx = context["canvas"]["width"].as<double> () / self->buffer_width;
+  sy = context["canvas"]["height"].as<double> () / self->buffer_height;
+  overlays = val::global ("Map").new_ ();
+  for (i = 0; i < n; i++) {
+    GstVideoOverlayRectangle *rect =
+        gst_video_overlay_composition_get_rectangle (composition, i);
+    guint seqnum = gst_video_overlay_rectangle_get_seqnum (rect);
+    gint x, y;
+    guint width, height;
+    val bitmap;
+
+    if (!self->val_overlays.isUndefined ())
+      bitmap = self->val_overlays.call<val> ("get", seqnum);
+    if (bitmap.isUndefined ()) {
+      GST_LOG_OBJECT (self, "New overlay rectangle %u", seqnum);
+      bitmap = gst_web_canvas_sink_overlay_bitmap (self, rect);
+      if (bitmap.isUndefined ())
+        continue;
+    }
+    overlays.call<void> ("set", seqnum, bitmap);
+
+    gst_video_overlay_rectangle_get_render_rectangle (
+        rect, &x, &y, &width, &height);
+    context.set (
+        "globalAlpha", gst_video_overlay_rectangle_get_global_alpha (rect));
+    context.call<void> (
+        "drawImage", bitmap, x * sx, y * sy, width * sx, height * sy);
+  }
+  context.set ("globalAlpha", 1.0);
+
+  /* Release the ImageBitmaps of the rectangles gone */
+  if (!self->val_overlays.isUndefined ()) {
+    /* clang-format off */
+    EM_ASM ({
+      const current = Emval.toValue ($1);
+
+      Emval.toValue ($0).forEach ((bitmap, seqnum) => {
+        if (!current.has (seqnum))
+          bitmap.close ();
+      });
+    }, self->val_overlays.as_handle (), overlays.as_handle ());
+    /* clang-format on */
+  }
+  self->val_overlays = n ? overlays : val::undefined ();
+}
+
+static void
+gst_web_canvas_sink_draw_frame (GstWebCanvasSink *self, val &source,
+    GstVideoOverlayComposition *composition)
+{
+  gint width = self->val_canvas["width"].as<int> ();
+  gint height = self->val_canvas["height"].as<int> ();
+  val context;
+
+  if (self->draw_mode == GST_WEB_CANVAS_SINK_DRAW_MODE_BITMAP_RENDERER) {
+    if (!composition) {
+      gst_web_canvas_sink_transfer_bitmap (self, source);
+      return;
+    }
+    /* Compose the frame and the overlays first */
+    context = gst_web_canvas_sink_ensure_offscreen (
+        self->val_compose, width, height);
+    context.call<void> ("drawImage", source, 0, 0, width, height);
+    gst_web_canvas_sink_draw_overlays (self, context, composition);
+    self->val_context.call<void> ("transferFromImageBitmap",
+        self->val_compose.call<val> ("transferToImageBitmap"));
+    return;
+  }
+
+  self->val_context.call<void> ("drawImage", source, 0, 0, width, height);
+  gst_web_canvas_sink_draw_overlays (self, self->val_context, composition);
+}
+
 static void
 gst_web_canvas_sink_draw_video_frame (gpointer data)
 {
   GstWebCanvasSinkDrawData *draw_data = (GstWebCanvasSinkDrawData *) data;
   GstWebCanvasSink *self = draw_data->self;
-  GstWebVideoFrame *vf;
   val video_frame;
 
   GST_DEBUG_OBJECT (self, "About to draw video frame %" GST_TIME_FORMAT,
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (draw_data->buffer)));
-  vf = (GstWebVideoFrame *) gst_buffer_get_memory (draw_data->buffer, 0);
-  video_frame = gst_web_video_frame_get_handle (vf);
-  self->val_context.call<void> ("drawImage", video_frame, 0, 0,
-      video_frame["displayWidth"], video_frame["displayHeight"], 0, 0,
-      self->val_canvas["width"], self->val_canvas["height"]);
-  gst_memory_unref (GST_MEMORY_CAST (vf));
+  video_frame = gst_web_video_frame_get_handle (draw_data->video_frame);
+  gst_web_canvas_sink_draw_frame (self, video_frame, draw_data->composition);
+}
+
+/* The browser converts the YUV frames, a VideoFrame is created from them */
+static void
+gst_web_canvas_sink_draw_raw_yuv (gpointer data)
+{
+  GstWebCanvasSinkDrawData *draw_data = (GstWebCanvasSinkDrawData *) data;
+  GstWebCanvasSink *self = draw_data->self;
+  GstMapInfo map;
+  val video_frame;
+
+  GST_DEBUG_OBJECT (self, "About to draw YUV from system memory %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (GST_BUFFER_PTS (draw_data->buffer)));
+  gst_buffer_map (draw_data->buffer, &map, GST_MAP_READ);
+  video_frame = gst_web_utils_video_frame_new (
+      draw_data->buffer, &self->info, map.data, map.size);
+  gst_buffer_unmap (draw_data->buffer, &map);
+
+  gst_web_canvas_sink_draw_frame (self, video_frame, draw_data->composition);
+  video_frame.call<void> ("close");
 }
 
 static void
@@ -181,29 +459,301 @@ gst_web_canvas_sink_draw_raw (gpointer data)
   GstWebCanvasSinkDrawData *draw_data = (GstWebCanvasSinkDrawData *) data;
   GstWebCanvasSink *self = draw_data->self;
   GstMapInfo map;
-  val buffer_data;
-  val image_data_data;
+  gsize size = (gsize) self->buffer_width * self->buffer_height * 4;
   val image_data;
-  val image_bitmap;
-  val options;
 
   GST_DEBUG_OBJECT (self, "About to draw from system memory %" GST_TIME_FORMAT,
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (draw_data->buffer)));
-  /* destination buffer */
-  /* map the buffer into an ArrayBuffer */
+  /* Copy the frame into the ImageData of the previous one, no allocation
+   * per frame */
+  image_data = self->val_image_data;
+  if (image_data.isUndefined () ||
+      image_data["width"].as<int> () != self->buffer_width ||
+      image_data["height"].as<int> () != self->buffer_height) {
+    image_data = val::global ("ImageData")
+                     .new_ (self->buffer_width, self->buffer_height);
+    self->val_image_data = image_data;
+  }
   gst_buffer_map (draw_data->buffer, &map, GST_MAP_READ);
-  buffer_data = val (typed_memory_view (map.size, map.data));
-  /* Create an ImageData */
-  image_data_data = val::global ("Uint8ClampedArray").new_ (buffer_data);
-  image_data =
-      val::global ("ImageData")
-          .new_ (image_data_data, self->buffer_width, self->buffer_height);
-  /* We create an ImageBitmap to support scaling if needed */
-  image_bitmap = val::global ("createImageBitmap") (image_data).await ();
-  self->val_context.call<void> ("drawImage", image_bitmap, 0, 0,
-      self->buffer_width, self->buffer_height, 0, 0, self->val_canvas["width"],
-      self->val_canvas["height"]);
+  image_data["data"].call<void> (
+      "set", val (typed_memory_view (size, map.data)));
   gst_buffer_unmap (draw_data->buffer, &map);
+
+  /* Same size, put it directly, the overlays go on top */
+  if (self->draw_mode == GST_WEB_CANVAS_SINK_DRAW_MODE_2D &&
+      self->val_canvas["width"].as<int> () == self->buffer_width &&
+      self->val_canvas["height"].as<int> () == self->buffer_height) {
+    self->val_context.call<void> ("putImageData", image_data, 0, 0);
+    gst_web_canvas_sink_draw_overlays (
+        self, self->val_context, draw_data->composition);
+    return;
+  }
+
+  if (self->draw_mode == GST_WEB_CANVAS_SINK_DRAW_MODE_BITMAP_RENDERER &&
+      !draw_data->composition) {
+    gst_web_canvas_sink_transfer_bitmap (self, image_data);
+    return;
+  }
+
+  /* Scale it through a canvas, synchronously, so nothing is drawn after the
+   * overlays */
+  gst_web_canvas_sink_ensure_offscreen (
+      self->val_staging, self->buffer_width, self->buffer_height)
+      .call<void> ("putImageData", image_data, 0, 0);
+  gst_web_canvas_sink_draw_frame (
+      self, self->val_staging, draw_data->composition);
+}
+
+static void
+gst_web_canvas_sink_draw_data_free (GstWebCanvasSinkDrawData *draw_data)
+{
+  if (draw_data->video_frame)
+    gst_memory_unref (GST_MEMORY_CAST (draw_data->video_frame));
+  if (draw_data->composition)
+    gst_video_overlay_composition_unref (draw_data->composition);
+  gst_buffer_unref (draw_data->buffer);
+  g_free (draw_data);
+}
+
+/* Drops the frame waiting for the next animation frame, if any */
+static void
+gst_web_canvas_sink_drop_pending (GstWebCanvasSink *self)
+{
+  GstWebCanvasSinkDrawData *draw_data;
+
+  g_mutex_lock (&self->present_lock);
+  draw_data = self->pending;
+  self->pending = NULL;
+  g_mutex_unlock (&self->present_lock);
+
+  if (draw_data)
+    gst_web_canvas_sink_draw_data_free (draw_data);
+}
+
+/* Called with present_lock taken */
+static void
+gst_web_canvas_sink_reset_qos (GstWebCanvasSink *self)
+{
+  self->qos_pending = FALSE;
+  self->last_left = GST_CLOCK_TIME_NONE;
+  self->avg_pt = GST_CLOCK_TIME_NONE;
+  self->avg_duration = GST_CLOCK_TIME_NONE;
+}
+
+/* Called with present_lock taken. The frame leaves the sink once drawn, its
+ * lateness and draw time after its running time. The time since the
+ * previous one left is what presenting a frame takes: a proportion above
+ * 1.0 means upstream produces more frames than we present, because they
+ * are superseded or drawn late */
+static void
+gst_web_canvas_sink_update_qos (GstWebCanvasSink *self,
+    GstClockTime running_time, GstClockTime duration,
+    GstClockTime draw_time, GstClockTimeDiff lateness)
+{
+  GstClockTime left, pt;
+
+  left = running_time + MAX (lateness, 0) + draw_time;
+  if (GST_CLOCK_TIME_IS_VALID (self->last_left) && left >= self->last_left)
+    pt = left - self->last_left;
+  else
+    pt = GST_CLOCK_TIME_IS_VALID (self->avg_pt) ? self->avg_pt : duration;
+  self->last_left = left;
+
+  if (!GST_CLOCK_TIME_IS_VALID (self->avg_pt))
+    self->avg_pt = pt;
+  else
+    self->avg_pt = UPDATE_RUNNING_AVG (self->avg_pt, pt);
+  if (!GST_CLOCK_TIME_IS_VALID (self->avg_duration))
+    self->avg_duration = duration;
+  else
+    self->avg_duration = UPDATE_RUNNING_AVG (self->avg_duration, duration);
+
+  self->qos_pending = TRUE;
+  self->qos_timestamp = running_time;
+  self->qos_diff = lateness - (GstClockTimeDiff) duration;
+  self->qos_proportion =
+      self->avg_duration ? (gdouble) self->avg_pt / self->avg_duration : 1.0;
+}
+
+/* Accounts a presented frame, and what to tell upstream about it: it is
+ * late when drawn after the next frame was due */
+static void
+gst_web_canvas_sink_update_stats (GstWebCanvasSink *self,
+    GstWebCanvasSinkDrawData *draw_data, GstClockTime draw_time,
+    GstClockTimeDiff lateness)
+{
+  GstClockTime duration = GST_BUFFER_DURATION (draw_data->buffer);
+  GstVideoInfo *info = &self->info;
+  GstClockTimeDiff diff;
+
+  if (!GST_CLOCK_TIME_IS_VALID (duration) && GST_VIDEO_INFO_FPS_N (info)) {
+    duration = gst_util_uint64_scale_int (GST_SECOND,
+        GST_VIDEO_INFO_FPS_D (info), GST_VIDEO_INFO_FPS_N (info));
+  }
+
+  GST_LOG_OBJECT (self, "Drawn in %" GST_TIME_FORMAT ", %" GST_STIME_FORMAT
+      " after being due", GST_TIME_ARGS (draw_time),
+      GST_STIME_ARGS (lateness));
+
+  g_mutex_lock (&self->present_lock);
+  self->presented++;
+  self->draw_time_total += draw_time;
+  self->draw_time_peak = MAX (self->draw_time_peak, draw_time);
+  /* Smoothed as the interarrival jitter of RFC 3550 */
+  if (self->presented > 1) {
+    diff = ABS (lateness - self->last_lateness);
+    self->jitter += (diff - self->jitter) / 16.0;
+  }
+  self->last_lateness = lateness;
+
+  if (GST_CLOCK_TIME_IS_VALID (draw_data->running_time) &&
+      GST_CLOCK_TIME_IS_VALID (duration) && duration > 0) {
+    gst_web_canvas_sink_update_qos (
+        self, draw_data->running_time, duration, draw_time, lateness);
+  }
+  g_mutex_unlock (&self->present_lock);
+}
+
+/* A bitmaprenderer draw is done, on the runner */
+static void
+gst_web_canvas_sink_on_drawn (guintptr data, bool result)
+{
+  GstWebCanvasSinkDrawData *draw_data = (GstWebCanvasSinkDrawData *) data;
+  GstWebCanvasSink *self = draw_data->self;
+
+  if (result) {
+    gst_web_canvas_sink_update_stats (self, draw_data,
+        (g_get_monotonic_time () - draw_data->start) * GST_USECOND,
+        (draw_data->start - draw_data->due) * GST_USECOND);
+  } else {
+    GST_WARNING_OBJECT (self, "Failed to draw %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (GST_BUFFER_PTS (draw_data->buffer)));
+  }
+  gst_web_canvas_sink_draw_data_free (draw_data);
+  gst_object_unref (self);
+}
+
+/* Draws the newest due frame once per display refresh, on the runner */
+static void
+gst_web_canvas_sink_on_animation_frame (guintptr data, double timestamp)
+{
+  GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (data);
+  GstWebCanvasSinkDrawData *draw_data;
+
+  g_mutex_lock (&self->present_lock);
+  draw_data = self->pending;
+  self->pending = NULL;
+  self->animation_frame_requested = FALSE;
+  g_mutex_unlock (&self->present_lock);
+
+  if (draw_data) {
+    gint64 start, end;
+
+    GST_LOG_OBJECT (self, "Presenting %" GST_TIME_FORMAT " at %f ms",
+        GST_TIME_ARGS (GST_BUFFER_PTS (draw_data->buffer)), timestamp);
+    self->val_drawn = val::undefined ();
+    start = draw_data->start = g_get_monotonic_time ();
+    draw_data->draw (draw_data);
+    end = g_get_monotonic_time ();
+
+    /* Measure the asynchronous draws once done */
+    if (!self->val_drawn.isUndefined ()) {
+      gst_object_ref (self);
+      /* clang-format off */
+      EM_ASM ({
+        const data = $0;
+
+        Emval.toValue ($1).then (() => {
+          Module.gst_web_canvas_sink_on_drawn (data, true);
+        }, () => {
+          Module.gst_web_canvas_sink_on_drawn (data, false);
+        });
+      }, (guintptr) draw_data, self->val_drawn.as_handle ());
+      /* clang-format on */
+      self->val_drawn = val::undefined ();
+    } else {
+      gst_web_canvas_sink_update_stats (self, draw_data,
+          (end - start) * GST_USECOND,
+          (start - draw_data->due) * GST_USECOND);
+      gst_web_canvas_sink_draw_data_free (draw_data);
+    }
+  }
+
+  gst_object_unref (self);
+}
+
+static void
+gst_web_canvas_sink_on_canvas (guintptr data, val canvas)
+{
+  GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (data);
+
+  self->val_canvas = canvas;
+}
+
+EMSCRIPTEN_BINDINGS (gst_web_canvas_sink)
+{
+  function ("gst_web_canvas_sink_on_animation_frame",
+      &gst_web_canvas_sink_on_animation_frame);
+  function ("gst_web_canvas_sink_on_canvas", &gst_web_canvas_sink_on_canvas);
+  function ("gst_web_canvas_sink_on_drawn", &gst_web_canvas_sink_on_drawn);
+}
+
+static void
+gst_web_canvas_sink_request_animation_frame (gpointer data)
+{
+  /* Workers without requestAnimationFrame draw at 60 Hz */
+  /* clang-format off */
+  EM_ASM ({
+    const data = $0;
+    const raf = globalThis.requestAnimationFrame ||
+        ((cb) => setTimeout (() => cb (performance.now ()), 1000 / 60));
+
+    raf ((timestamp) => {
+      Module.gst_web_canvas_sink_on_animation_frame (data, timestamp);
+    });
+  }, (guintptr) data);
+  /* clang-format on */
+}
+
+/* Converts the raw frames into tightly packed RGBA with the SIMD kernels,
+ * unless they are already */
+static GstBuffer *
+gst_web_canvas_sink_ensure_rgba (GstWebCanvasSink *self, GstBuffer *buf)
+{
+  GstVideoFrame in_frame, out_frame;
+  gboolean ret;
+
+  if (!gst_video_frame_map (&in_frame, &self->info, buf, GST_MAP_READ))
+    return NULL;
+
+  if (GST_VIDEO_FRAME_FORMAT (&in_frame) == GST_VIDEO_FORMAT_RGBA &&
+      GST_VIDEO_FRAME_PLANE_OFFSET (&in_frame, 0) == 0 &&
+      GST_VIDEO_FRAME_PLANE_STRIDE (&in_frame, 0) ==
+          GST_VIDEO_FRAME_WIDTH (&in_frame) * 4) {
+    gst_video_frame_unmap (&in_frame);
+    return gst_buffer_ref (buf);
+  }
+
+  /* Still referenced by the frame waiting to be presented */
+  if (self->rgba_buffer && !gst_buffer_is_writable (self->rgba_buffer))
+    gst_clear_buffer (&self->rgba_buffer);
+  if (!self->rgba_buffer) {
+    self->rgba_buffer =
+        gst_buffer_new_allocate (NULL, self->rgba_info.size, NULL);
+  }
+  if (!gst_video_frame_map (
+          &out_frame, &self->rgba_info, self->rgba_buffer, GST_MAP_WRITE)) {
+    gst_video_frame_unmap (&in_frame);
+    return NULL;
+  }
+  ret = gst_web_simd_convert_frame (&in_frame, &out_frame);
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+  if (!ret)
+    return NULL;
+
+  GST_BUFFER_PTS (self->rgba_buffer) = GST_BUFFER_PTS (buf);
+  return gst_buffer_ref (self->rgba_buffer);
 }
 
 static void
@@ -211,11 +761,102 @@ gst_web_canvas_sink_setup (gpointer data)
 {
   GstWebCanvasSinkSetupData *setup_data = (GstWebCanvasSinkSetupData *) data;
   GstWebCanvasSink *self = setup_data->self;
+  const gchar *context_type;
+
+  /* The runner is created with our id as its canvas, which transfers it with
+   * transferControlToOffscreen() to the runner worker when built with
+   * -sOFFSCREENCANVAS_SUPPORT. Look for it, then for a DOM canvas with that
+   * id if the runner has a document, then for Module.canvas */
+  /* clang-format off */
+  EM_ASM ({
+    const id = UTF8ToString ($1);
+    let canvas = null;
+
+    if (typeof GL !== 'undefined' && GL.offscreenCanvases) {
+      const offscreen = GL.offscreenCanvases[id.replace (/^#/, '')];
+
+      if (offscreen)
+        canvas = offscreen.offscreenCanvas || offscreen;
+    }
+    if (!canvas && typeof document !== 'undefined')
+      canvas = document.querySelector (id);
+    if (!canvas)
+      canvas = Module.canvas;
+    Module.gst_web_canvas_sink_on_canvas ($0, canvas || null);
+  }, (guintptr) self, self->id);
+  /* clang-format on */
+
+  if (self->val_canvas.isNull () || self->val_canvas.isUndefined ()) {
+    setup_data->ret = FALSE;
+    return;
+  }
 
-  /* FIXME how to handle the case of multiple canvases? (RDI-2858) */
-  self->val_canvas = val::module_property ("canvas");
+  context_type =
+      self->draw_mode == GST_WEB_CANVAS_SINK_DRAW_MODE_BITMAP_RENDERER
+          ? "bitmaprenderer"
+          : "2d";
   self->val_context =
-      self->val_canvas.call<val> ("getContext", std::string ("2d"));
+      self->val_canvas.call<val> ("getContext", std::string (context_type));
+  setup_data->ret = !self->val_context.isNull ();
+
+  GST_OBJECT_LOCK (self);
+  self->canvas_width = self->val_canvas["width"].as<int> ();
+  self->canvas_height = self->val_canvas["height"].as<int> ();
+  GST_OBJECT_UNLOCK (self);
+}
+
+/* The base class sends its QoS events once show_frame returns, before the
+ * frame is drawn. Replace them with what the last presentation measured */
+static GstPadProbeReturn
+gst_web_canvas_sink_qos_probe (
+    GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+  GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (user_data);
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+  GstEvent *qos = NULL;
+
+  if (GST_EVENT_TYPE (event) != GST_EVENT_QOS)
+    return GST_PAD_PROBE_OK;
+
+  g_mutex_lock (&self->present_lock);
+  if (self->qos_pending) {
+    qos = gst_event_new_qos (GST_QOS_TYPE_OVERFLOW, self->qos_proportion,
+        self->qos_diff, self->qos_timestamp);
+    self->qos_pending = FALSE;
+  }
+  g_mutex_unlock (&self->present_lock);
+
+  /* Nothing presented since the last one */
+  if (!qos)
+    return GST_PAD_PROBE_DROP;
+
+  GST_LOG_OBJECT (self, "Sending %" GST_PTR_FORMAT, qos);
+  gst_event_unref (event);
+  GST_PAD_PROBE_INFO_DATA (info) = qos;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstStructure *
+gst_web_canvas_sink_get_stats (GstWebCanvasSink *self)
+{
+  GstStructure *s;
+  guint64 dropped = 0;
+
+  /* The base class accounts the frames too late to be shown */
+  s = gst_base_sink_get_stats (GST_BASE_SINK (self));
+  gst_structure_get_uint64 (s, "dropped", &dropped);
+
+  g_mutex_lock (&self->present_lock);
+  gst_structure_set (s, "rendered", G_TYPE_UINT64, self->presented,
+      "dropped", G_TYPE_UINT64, dropped + self->dropped,
+      "average-draw-time", G_TYPE_UINT64,
+      self->presented ? self->draw_time_total / self->presented : 0,
+      "peak-draw-time", G_TYPE_UINT64, self->draw_time_peak, "jitter",
+      G_TYPE_UINT64, (guint64) self->jitter, NULL);
+  g_mutex_unlock (&self->present_lock);
+
+  return s;
 }
 
 static GstFlowReturn
@@ -223,10 +864,13 @@ gst_web_canvas_sink_show_frame (GstVideoSink *sink, GstBuffer *buf)
 {
   GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (sink);
   GstWebCanvasSinkDrawData data;
+  GstWebCanvasSinkDrawData *superseded;
+  GstVideoOverlayCompositionMeta *meta;
   GstWebRunner *runner;
   GstWebRunnerCB cb;
   GstCapsFeatures *features;
   GstCaps *caps;
+  gboolean request;
 
   GST_DEBUG_OBJECT (self, "show frame, pts = %" GST_TIME_FORMAT,
       GST_TIME_ARGS (GST_BUFFER_PTS (buf)));
@@ -238,6 +882,8 @@ gst_web_canvas_sink_show_frame (GstVideoSink *sink, GstBuffer *buf)
   if (features && gst_caps_features_contains (
                       features, GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME)) {
     cb = gst_web_canvas_sink_draw_video_frame;
+  } else if (GST_VIDEO_INFO_IS_YUV (&self->info)) {
+    cb = gst_web_canvas_sink_draw_raw_yuv;
   } else {
     cb = gst_web_canvas_sink_draw_raw;
   }
@@ -246,7 +892,61 @@ gst_web_canvas_sink_show_frame (GstVideoSink *sink, GstBuffer *buf)
   runner = gst_web_canvas_get_runner (self->canvas);
   data.self = self;
   data.buffer = buf;
-  gst_web_runner_send_message (runner, cb, &data);
+  data.video_frame = NULL;
+  if (cb == gst_web_canvas_sink_draw_raw) {
+    data.buffer = gst_web_canvas_sink_ensure_rgba (self, buf);
+    if (!data.buffer) {
+      GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+          ("Impossible to convert the frame to RGBA"));
+      gst_object_unref (GST_OBJECT (runner));
+      return GST_FLOW_ERROR;
+    }
+  } else if (cb == gst_web_canvas_sink_draw_raw_yuv) {
+    data.buffer = gst_buffer_ref (buf);
+  } else {
+    GstWebVideoFrame *vf;
+
+    /* The decoder might be running on its own runner */
+    vf = (GstWebVideoFrame *) gst_buffer_peek_memory (buf, 0);
+    data.video_frame = gst_web_video_frame_import (vf, runner);
+    if (!data.video_frame) {
+      GST_ELEMENT_WARNING (self, RESOURCE, FAILED, (NULL),
+          ("Impossible to get the VideoFrame on our runner"));
+      gst_object_unref (GST_OBJECT (runner));
+      return GST_FLOW_OK;
+    }
+  }
+  if (data.video_frame)
+    data.buffer = gst_buffer_ref (buf);
+  /* The RGBA buffer the raw frames are converted to has no metas */
+  meta = gst_buffer_get_video_overlay_composition_meta (buf);
+  data.composition =
+      meta ? gst_video_overlay_composition_ref (meta->overlay) : NULL;
+  data.draw = cb;
+  data.running_time = gst_segment_to_running_time (
+      &GST_BASE_SINK (sink)->segment, GST_FORMAT_TIME, GST_BUFFER_PTS (buf));
+  data.due = g_get_monotonic_time ();
+
+  /* Do not wait for the draw, it replaces the frame not presented yet */
+  g_mutex_lock (&self->present_lock);
+  superseded = self->pending;
+  self->pending = (GstWebCanvasSinkDrawData *) g_memdup2 (&data, sizeof data);
+  if (superseded)
+    self->dropped++;
+  request = !self->animation_frame_requested;
+  self->animation_frame_requested = TRUE;
+  g_mutex_unlock (&self->present_lock);
+
+  if (superseded) {
+    GST_LOG_OBJECT (self, "Dropping %" GST_TIME_FORMAT ", not presented",
+        GST_TIME_ARGS (GST_BUFFER_PTS (superseded->buffer)));
+    gst_web_canvas_sink_draw_data_free (superseded);
+  }
+  if (request) {
+    gst_web_runner_send_message_async (runner,
+        gst_web_canvas_sink_request_animation_frame, gst_object_ref (self),
+        NULL);
+  }
   gst_object_unref (GST_OBJECT (runner));
 
   GST_DEBUG_OBJECT (self, "show frame done, pts = %" GST_TIME_FORMAT,
@@ -254,6 +954,37 @@ gst_web_canvas_sink_show_frame (GstVideoSink *sink, GstBuffer *buf)
   return GST_FLOW_OK;
 }
 
+/* Prefers frames of the size of the canvas first, drawn without scaling,
+ * so upstream scalers do not produce bigger frames than needed */
+static GstCaps *
+gst_web_canvas_sink_get_caps (GstBaseSink *sink, GstCaps *filter)
+{
+  GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (sink);
+  GstCaps *caps, *tmp;
+  gint width, height;
+
+  caps = gst_pad_get_pad_template_caps (GST_BASE_SINK_PAD (sink));
+  GST_OBJECT_LOCK (self);
+  width = self->canvas_width;
+  height = self->canvas_height;
+  GST_OBJECT_UNLOCK (self);
+
+  if (width > 0 && height > 0) {
+    tmp = gst_caps_copy (caps);
+    gst_caps_set_simple (tmp, "width", G_TYPE_INT, width, "height",
+        G_TYPE_INT, height, NULL);
+    caps = gst_caps_merge (tmp, caps);
+  }
+
+  if (filter) {
+    tmp = gst_caps_intersect_full (filter, caps, GST_CAPS_INTERSECT_FIRST);
+    gst_caps_unref (caps);
+    caps = tmp;
+  }
+
+  return caps;
+}
+
 static gboolean
 gst_web_canvas_sink_set_info (
     GstVideoSink *sink, GstCaps *caps, const GstVideoInfo *info)
@@ -262,6 +993,10 @@ gst_web_canvas_sink_set_info (
 
   self->buffer_width = info->width;
   self->buffer_height = info->height;
+  self->info = *info;
+  gst_video_info_set_format (
+      &self->rgba_info, GST_VIDEO_FORMAT_RGBA, info->width, info->height);
+  gst_clear_buffer (&self->rgba_buffer);
   return TRUE;
 }
 
@@ -330,6 +1065,16 @@ gst_web_canvas_sink_start (GstBaseSink *sink)
 
   GST_DEBUG_OBJECT (self, "Start webcanvassink");
 
+  g_mutex_lock (&self->present_lock);
+  self->presented = 0;
+  self->dropped = 0;
+  self->draw_time_total = 0;
+  self->draw_time_peak = 0;
+  self->last_lateness = 0;
+  self->jitter = 0;
+  gst_web_canvas_sink_reset_qos (self);
+  g_mutex_unlock (&self->present_lock);
+
   /* Ensure that we have a GstWebCanvas context */
   if (!gst_web_utils_element_ensure_canvas (self, &self->canvas, self->id)) {
     GST_ERROR_OBJECT (self, "Failed requesting a WebCanvas context");
@@ -346,7 +1091,17 @@ gst_web_canvas_sink_start (GstBaseSink *sink)
 
   /* TODO pick the context from the canvas */
   data.self = self;
+  data.ret = FALSE;
   gst_web_runner_send_message (runner, gst_web_canvas_sink_setup, &data);
+  if (!data.ret) {
+    GST_ELEMENT_ERROR (self, RESOURCE, NOT_FOUND, (NULL),
+        ("Impossible to get a %s context of the canvas '%s'",
+            self->draw_mode == GST_WEB_CANVAS_SINK_DRAW_MODE_BITMAP_RENDERER
+                ? "bitmaprenderer"
+                : "2d",
+            self->id));
+    goto done;
+  }
 
   gst_web_canvas_sink_set_mouse_event_handlers (self);
 
@@ -388,6 +1143,97 @@ gst_web_canvas_sink_query (GstElement *element, GstQuery *query)
   return ret;
 }
 
+/* Proposes buffers the raw paths draw without any repack: the default video
+ * layout is tightly strided, aligned for the SIMD kernels. They go back to
+ * the pool once drawn, when the sink releases the frame */
+static gboolean
+gst_web_canvas_sink_propose_allocation (GstBaseSink *sink, GstQuery *query)
+{
+  GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (sink);
+  GstStructure *overlay_params = NULL;
+  GstAllocationParams params;
+  GstCapsFeatures *features;
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstVideoInfo info;
+  gboolean need_pool;
+  GstCaps *caps;
+
+  gst_query_parse_allocation (query, &caps, &need_pool);
+  if (!caps) {
+    GST_DEBUG_OBJECT (self, "No caps specified");
+    return FALSE;
+  }
+
+  /* The overlays are drawn by us, at the canvas resolution if known */
+  GST_OBJECT_LOCK (self);
+  if (self->canvas_width > 0 && self->canvas_height > 0) {
+    overlay_params = gst_structure_new ("GstVideoOverlayCompositionMeta",
+        "width", G_TYPE_UINT, self->canvas_width, "height", G_TYPE_UINT,
+        self->canvas_height, NULL);
+  }
+  GST_OBJECT_UNLOCK (self);
+  gst_query_add_allocation_meta (
+      query, GST_VIDEO_OVERLAY_COMPOSITION_META_API_TYPE, overlay_params);
+  if (overlay_params)
+    gst_structure_free (overlay_params);
+
+  /* The VideoFrames are not allocated in the wasm memory */
+  features = gst_caps_get_features (caps, 0);
+  if (features && gst_caps_features_contains (
+                      features, GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME))
+    return TRUE;
+
+  if (!gst_video_info_from_caps (&info, caps)) {
+    GST_DEBUG_OBJECT (self, "Invalid caps specified");
+    return FALSE;
+  }
+
+  gst_allocation_params_init (&params);
+  params.align = 15;
+  gst_query_add_allocation_param (query, NULL, &params);
+  /* Any other layout is handled too */
+  gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+
+  if (!need_pool)
+    return TRUE;
+
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (
+      config, caps, info.size, POOL_MIN_BUFFERS, 0);
+  gst_buffer_pool_config_set_allocator (config, NULL, &params);
+  gst_buffer_pool_config_add_option (
+      config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+  if (!gst_buffer_pool_set_config (pool, config)) {
+    GST_WARNING_OBJECT (self, "Failed to set the pool config");
+    gst_object_unref (pool);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (self, "Proposing %" GST_PTR_FORMAT, pool);
+  gst_query_add_allocation_pool (query, pool, info.size, POOL_MIN_BUFFERS, 0);
+  gst_object_unref (pool);
+
+  return TRUE;
+}
+
+static gboolean
+gst_web_canvas_sink_event (GstBaseSink *sink, GstEvent *event)
+{
+  GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (sink);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START) {
+    gst_web_canvas_sink_drop_pending (self);
+    /* The running time starts over */
+    g_mutex_lock (&self->present_lock);
+    gst_web_canvas_sink_reset_qos (self);
+    g_mutex_unlock (&self->present_lock);
+  }
+
+  return GST_BASE_SINK_CLASS (parent_class)->event (sink, event);
+}
+
 static void
 gst_web_canvas_sink_get_property (
     GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
@@ -398,18 +1244,68 @@ gst_web_canvas_sink_get_property (
     case PROP_ID:
       g_value_set_string (value, src->id);
       break;
+    case PROP_DRAW_MODE:
+      g_value_set_enum (value, src->draw_mode);
+      break;
+    case PROP_PRESENTED:
+      g_mutex_lock (&src->present_lock);
+      g_value_set_uint64 (value, src->presented);
+      g_mutex_unlock (&src->present_lock);
+      break;
+    case PROP_DROPPED:
+      g_mutex_lock (&src->present_lock);
+      g_value_set_uint64 (value, src->dropped);
+      g_mutex_unlock (&src->present_lock);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_web_canvas_sink_get_stats (src));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+/* Releases what was created to draw the frames, the ImageBitmaps of the
+ * overlays hold GPU memory until closed */
+static void
+gst_web_canvas_sink_teardown (gpointer data)
+{
+  GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (data);
+
+  if (!self->val_overlays.isUndefined ()) {
+    /* clang-format off */
+    EM_ASM ({
+      Emval.toValue ($0).forEach ((bitmap) => bitmap.close ());
+    }, self->val_overlays.as_handle ());
+    /* clang-format on */
+  }
+  self->val_overlays = val::undefined ();
+  self->val_image_data = val::undefined ();
+  self->val_staging = val::undefined ();
+  self->val_compose = val::undefined ();
+}
+
 static gboolean
 gst_web_canvas_sink_stop (GstBaseSink *sink)
 {
   GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (sink);
 
   gst_web_canvas_sink_set_mouse_event_handlers (self, FALSE);
+  gst_web_canvas_sink_drop_pending (self);
+  gst_clear_buffer (&self->rgba_buffer);
+  if (self->canvas) {
+    GstWebRunner *runner = gst_web_canvas_get_runner (self->canvas);
+
+    gst_web_runner_send_message (
+        runner, gst_web_canvas_sink_teardown, self);
+    gst_object_unref (runner);
+  }
+
+  GST_OBJECT_LOCK (self);
+  self->canvas_width = 0;
+  self->canvas_height = 0;
+  GST_OBJECT_UNLOCK (self);
 
   return TRUE;
 }
@@ -425,6 +1321,9 @@ gst_web_canvas_sink_set_property (
       g_free (src->id);
       src->id = g_value_dup_string (value);
       break;
+    case PROP_DRAW_MODE:
+      src->draw_mode = (GstWebCanvasSinkDrawMode) g_value_get_enum (value);
+      break;
     default:
       break;
   }
@@ -436,6 +1335,7 @@ gst_web_canvas_sink_finalize (GObject *object)
   GstWebCanvasSink *self = GST_WEB_CANVAS_SINK (object);
 
   g_clear_pointer (&self->id, g_free);
+  g_mutex_clear (&self->present_lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -443,6 +1343,11 @@ gst_web_canvas_sink_finalize (GObject *object)
 static void
 gst_web_canvas_sink_init (GstWebCanvasSink *sink)
 {
+  g_mutex_init (&sink->present_lock);
+  sink->draw_mode = DEFAULT_DRAW_MODE;
+  gst_pad_add_probe (GST_BASE_SINK_PAD (sink),
+      GST_PAD_PROBE_TYPE_EVENT_UPSTREAM, gst_web_canvas_sink_qos_probe, sink,
+      NULL);
 }
 
 static void
@@ -461,6 +1366,24 @@ gst_web_canvas_sink_class_init (GstWebCanvasSinkClass *klass)
           DEFAULT_CANVAS_ID,
           (GParamFlags) (G_PARAM_READWRITE | G_PARAM_CONSTRUCT |
                          G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_DRAW_MODE,
+      g_param_spec_enum ("draw-mode", "Draw mode",
+          "How to draw the frames on the canvas",
+          GST_TYPE_WEB_CANVAS_SINK_DRAW_MODE, DEFAULT_DRAW_MODE,
+          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+                         GST_PARAM_MUTABLE_READY)));
+  g_object_class_install_property (gobject_class, PROP_PRESENTED,
+      g_param_spec_uint64 ("presented", "Presented",
+          "Frames drawn on an animation frame", 0, G_MAXUINT64, 0,
+          (GParamFlags) (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_DROPPED,
+      g_param_spec_uint64 ("dropped", "Dropped",
+          "Frames replaced by a newer one before being drawn", 0,
+          G_MAXUINT64, 0,
+          (GParamFlags) (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+  /* Extended with the frames presented, the draw time and the presentation
+   * jitter */
+  g_object_class_override_property (gobject_class, PROP_STATS, "stats");
 
   element_class = GST_ELEMENT_CLASS (klass);
   element_class->set_context = gst_web_canvas_sink_set_context;
@@ -473,6 +1396,9 @@ gst_web_canvas_sink_class_init (GstWebCanvasSinkClass *klass)
   basesink_class = GST_BASE_SINK_CLASS (klass);
   basesink_class->start = gst_web_canvas_sink_start;
   basesink_class->stop = gst_web_canvas_sink_stop;
+  basesink_class->event = gst_web_canvas_sink_event;
+  basesink_class->get_caps = gst_web_canvas_sink_get_caps;
+  basesink_class->propose_allocation = gst_web_canvas_sink_propose_allocation;
   videosink_class = GST_VIDEO_SINK_CLASS (klass);
   videosink_class->show_frame = gst_web_canvas_sink_show_frame;
   videosink_class->set_info = gst_web_canvas_sink_set_info;
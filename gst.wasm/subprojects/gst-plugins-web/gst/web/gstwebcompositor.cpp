@@ -0,0 +1,742 @@
+/*
+ * GStreamer - gst.wasm WebCompositor source
+ *
+ * Copyright 2025 Fluendo S.A.
+ * @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * SECTION:element-webcompositor
+ *
+ * Composites several VideoFrames into a new one, drawing them with
+ * drawImage() on an OffscreenCanvas of the runner, so the browser does all
+ * the pixel work. As compositor, the inputs are synchronized on their
+ * running time and every sink pad has its position, size, alpha and
+ * zorder.
+ *
+ * The inputs are expected to be on the runner of the canvas, as the
+ * decoders with runner-mode=shared. VideoFrames can not be shared among
+ * runners, so the ones coming from another runner are copied through the
+ * wasm memory on every aggregation, and a warning is posted.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 webcompositor name=c sink_1::xpos=640 !
+ *     webcanvassink
+ *     videotestsrc ! webupload ! c.
+ *     videotestsrc pattern=ball ! webupload ! c.
+ * ]|
+ *
+ * TODO:
+ * - Add a background property
+ * - Add the sizing policy of compositor
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/video/video.h>
+#include <gst/video/gstvideoaggregator.h>
+#include <emscripten/bind.h>
+#include <gst/web/gstwebvideoframe.h>
+#include <gst/web/gstwebcanvas.h>
+#include <gst/web/gstwebutils.h>
+#include <gst/web/gstwebrunner.h>
+
+#include "gstweb.h"
+#include "gstwebcompositor.h"
+
+using namespace emscripten;
+
+#define GST_TYPE_WEB_COMPOSITOR_PAD (gst_web_compositor_pad_get_type ())
+#define GST_WEB_COMPOSITOR_PAD(obj)                                           \
+  (G_TYPE_CHECK_INSTANCE_CAST (                                               \
+      (obj), GST_TYPE_WEB_COMPOSITOR_PAD, GstWebCompositorPad))
+
+#define GST_TYPE_WEB_COMPOSITOR (gst_web_compositor_get_type ())
+#define GST_WEB_COMPOSITOR(obj)                                               \
+  (G_TYPE_CHECK_INSTANCE_CAST (                                               \
+      (obj), GST_TYPE_WEB_COMPOSITOR, GstWebCompositor))
+
+#define gst_web_compositor_parent_class parent_class
+#define GST_CAT_DEFAULT gst_web_compositor_debug_category
+GST_DEBUG_CATEGORY_STATIC (gst_web_compositor_debug_category);
+
+#define DEFAULT_PAD_XPOS 0
+#define DEFAULT_PAD_YPOS 0
+#define DEFAULT_PAD_WIDTH 0
+#define DEFAULT_PAD_HEIGHT 0
+#define DEFAULT_PAD_ALPHA 1.0
+
+typedef struct _GstWebCompositorPad
+{
+  GstVideoAggregatorPad base;
+
+  gint xpos;
+  gint ypos;
+  gint width;
+  gint height;
+  gdouble alpha;
+} GstWebCompositorPad;
+
+typedef struct _GstWebCompositorPadClass
+{
+  GstVideoAggregatorPadClass base;
+} GstWebCompositorPadClass;
+
+typedef struct _GstWebCompositor
+{
+  GstVideoAggregator base;
+  GstWebCanvas *canvas;
+  /* Where the inputs are drawn, on the runner */
+  val val_canvas;
+  val val_context;
+  /* Whether the copy of the inputs from other runners was warned */
+  gboolean warned_foreign_runner;
+} GstWebCompositor;
+
+typedef struct _GstWebCompositorClass
+{
+  GstVideoAggregatorClass base;
+} GstWebCompositorClass;
+
+typedef struct _GstWebCompositorInput
+{
+  /* The VideoFrame of the current buffer of the pad, on our runner */
+  GstWebVideoFrame *video_frame;
+  gint x;
+  gint y;
+  gint width;
+  gint height;
+  gdouble alpha;
+} GstWebCompositorInput;
+
+typedef struct _GstWebCompositorDrawData
+{
+  GstWebCompositor *self;
+  GstWebRunner *runner;
+  /* The inputs, from the bottom to the top */
+  GArray *inputs;
+  gint width;
+  gint height;
+  GstClockTime pts;
+  GstClockTime duration;
+  GstWebVideoFrame *result;
+} GstWebCompositorDrawData;
+
+enum
+{
+  PROP_PAD_0,
+  PROP_PAD_XPOS,
+  PROP_PAD_YPOS,
+  PROP_PAD_WIDTH,
+  PROP_PAD_HEIGHT,
+  PROP_PAD_ALPHA,
+};
+
+static GstStaticPadTemplate static_sink_template =
+    GST_STATIC_PAD_TEMPLATE ("sink_%u", GST_PAD_SINK, GST_PAD_REQUEST,
+        GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES (
+            GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME,
+            GST_WEB_MEMORY_VIDEO_FORMATS_STR)));
+
+/* What a VideoFrame created from a canvas holds */
+static GstStaticPadTemplate static_src_template =
+    GST_STATIC_PAD_TEMPLATE ("src", GST_PAD_SRC, GST_PAD_ALWAYS,
+        GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES (
+            GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME, "RGBA")));
+
+G_DEFINE_TYPE (GstWebCompositorPad, gst_web_compositor_pad,
+    GST_TYPE_VIDEO_AGGREGATOR_PAD);
+
+static void
+gst_web_compositor_pad_get_output_size (
+    GstWebCompositorPad *pad, gint *width, gint *height)
+{
+  GstVideoAggregatorPad *vpad = GST_VIDEO_AGGREGATOR_PAD (pad);
+
+  *width = pad->width > 0 ? pad->width : GST_VIDEO_INFO_WIDTH (&vpad->info);
+  *height =
+      pad->height > 0 ? pad->height : GST_VIDEO_INFO_HEIGHT (&vpad->info);
+}
+
+/* The buffers are VideoFrames, there is nothing to map */
+static gboolean
+gst_web_compositor_pad_prepare_frame (GstVideoAggregatorPad *pad,
+    GstVideoAggregator *vagg, GstBuffer *buffer,
+    GstVideoFrame *prepared_frame)
+{
+  return TRUE;
+}
+
+static void
+gst_web_compositor_pad_clean_frame (GstVideoAggregatorPad *pad,
+    GstVideoAggregator *vagg, GstVideoFrame *prepared_frame)
+{
+}
+
+static void
+gst_web_compositor_pad_get_property (
+    GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  GstWebCompositorPad *pad = GST_WEB_COMPOSITOR_PAD (object);
+
+  GST_OBJECT_LOCK (pad);
+  switch (prop_id) {
+    case PROP_PAD_XPOS:
+      g_value_set_int (value, pad->xpos);
+      break;
+    case PROP_PAD_YPOS:
+      g_value_set_int (value, pad->ypos);
+      break;
+    case PROP_PAD_WIDTH:
+      g_value_set_int (value, pad->width);
+      break;
+    case PROP_PAD_HEIGHT:
+      g_value_set_int (value, pad->height);
+      break;
+    case PROP_PAD_ALPHA:
+      g_value_set_double (value, pad->alpha);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (pad);
+}
+
+static void
+gst_web_compositor_pad_set_property (
+    GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  GstWebCompositorPad *pad = GST_WEB_COMPOSITOR_PAD (object);
+
+  GST_OBJECT_LOCK (pad);
+  switch (prop_id) {
+    case PROP_PAD_XPOS:
+      pad->xpos = g_value_get_int (value);
+      break;
+    case PROP_PAD_YPOS:
+      pad->ypos = g_value_get_int (value);
+      break;
+    case PROP_PAD_WIDTH:
+      pad->width = g_value_get_int (value);
+      break;
+    case PROP_PAD_HEIGHT:
+      pad->height = g_value_get_int (value);
+      break;
+    case PROP_PAD_ALPHA:
+      pad->alpha = g_value_get_double (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (pad);
+}
+
+static void
+gst_web_compositor_pad_init (GstWebCompositorPad *pad)
+{
+  pad->xpos = DEFAULT_PAD_XPOS;
+  pad->ypos = DEFAULT_PAD_YPOS;
+  pad->width = DEFAULT_PAD_WIDTH;
+  pad->height = DEFAULT_PAD_HEIGHT;
+  pad->alpha = DEFAULT_PAD_ALPHA;
+}
+
+static void
+gst_web_compositor_pad_class_init (GstWebCompositorPadClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstVideoAggregatorPadClass *vaggpad_class =
+      GST_VIDEO_AGGREGATOR_PAD_CLASS (klass);
+
+  gobject_class->set_property = gst_web_compositor_pad_set_property;
+  gobject_class->get_property = gst_web_compositor_pad_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_PAD_XPOS,
+      g_param_spec_int ("xpos", "X Position", "X position of the picture",
+          G_MININT, G_MAXINT, DEFAULT_PAD_XPOS,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE |
+                         G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_PAD_YPOS,
+      g_param_spec_int ("ypos", "Y Position", "Y position of the picture",
+          G_MININT, G_MAXINT, DEFAULT_PAD_YPOS,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE |
+                         G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_PAD_WIDTH,
+      g_param_spec_int ("width", "Width",
+          "Width of the picture, 0 for the input width", G_MININT, G_MAXINT,
+          DEFAULT_PAD_WIDTH,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE |
+                         G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_PAD_HEIGHT,
+      g_param_spec_int ("height", "Height",
+          "Height of the picture, 0 for the input height", G_MININT,
+          G_MAXINT, DEFAULT_PAD_HEIGHT,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE |
+                         G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (gobject_class, PROP_PAD_ALPHA,
+      g_param_spec_double ("alpha", "Alpha", "Alpha of the picture", 0.0,
+          1.0, DEFAULT_PAD_ALPHA,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE |
+                         G_PARAM_STATIC_STRINGS)));
+
+  vaggpad_class->prepare_frame = gst_web_compositor_pad_prepare_frame;
+  vaggpad_class->clean_frame = gst_web_compositor_pad_clean_frame;
+}
+
+static void gst_web_compositor_child_proxy_init (
+    gpointer g_iface, gpointer iface_data);
+
+G_DEFINE_TYPE_WITH_CODE (GstWebCompositor, gst_web_compositor,
+    GST_TYPE_VIDEO_AGGREGATOR,
+    G_IMPLEMENT_INTERFACE (
+        GST_TYPE_CHILD_PROXY, gst_web_compositor_child_proxy_init);
+    GST_DEBUG_CATEGORY_INIT (gst_web_compositor_debug_category,
+        "webcompositor", 0, "Web Compositor"));
+GST_ELEMENT_REGISTER_DEFINE (web_compositor, "webcompositor",
+    GST_RANK_NONE, GST_TYPE_WEB_COMPOSITOR);
+
+static void
+gst_web_compositor_input_clear (GstWebCompositorInput *input)
+{
+  if (input->video_frame)
+    gst_memory_unref (GST_MEMORY_CAST (input->video_frame));
+}
+
+static void
+gst_web_compositor_draw (gpointer data)
+{
+  GstWebCompositorDrawData *draw_data = (GstWebCompositorDrawData *) data;
+  GstWebCompositor *self = draw_data->self;
+  val init = val::object ();
+  val video_frame;
+  guint i;
+
+  /* Reuse the canvas while the output size does not change */
+  if (self->val_canvas.isUndefined () ||
+      self->val_canvas["width"].as<int> () != draw_data->width ||
+      self->val_canvas["height"].as<int> () != draw_data->height) {
+    GST_DEBUG_OBJECT (self, "Creating a %dx%d canvas", draw_data->width,
+        draw_data->height);
+    self->val_canvas = val::global ("OffscreenCanvas")
+                           .new_ (draw_data->width, draw_data->height);
+    self->val_context =
+        self->val_canvas.call<val> ("getContext", std::string ("2d"));
+  }
+
+  self->val_context.set ("globalAlpha", 1.0);
+  self->val_context.call<void> (
+      "fillRect", 0, 0, draw_data->width, draw_data->height);
+  for (i = 0; i < draw_data->inputs->len; i++) {
+    GstWebCompositorInput *input =
+        &g_array_index (draw_data->inputs, GstWebCompositorInput, i);
+
+    if (!input->video_frame)
+      continue;
+    self->val_context.set ("globalAlpha", input->alpha);
+    self->val_context.call<void> ("drawImage",
+        gst_web_video_frame_get_handle (input->video_frame), input->x,
+        input->y, input->width, input->height);
+  }
+
+  init.set ("timestamp", GST_CLOCK_TIME_IS_VALID (draw_data->pts)
+                             ? (double) GST_TIME_AS_USECONDS (draw_data->pts)
+                             : 0.0);
+  if (GST_CLOCK_TIME_IS_VALID (draw_data->duration)) {
+    init.set (
+        "duration", (double) GST_TIME_AS_USECONDS (draw_data->duration));
+  }
+  video_frame = val::global ("VideoFrame").new_ (self->val_canvas, init);
+  draw_data->result =
+      gst_web_video_frame_wrap (video_frame, draw_data->runner);
+}
+
+static void
+gst_web_compositor_teardown (gpointer data)
+{
+  GstWebCompositor *self = GST_WEB_COMPOSITOR (data);
+
+  self->val_context = val::undefined ();
+  self->val_canvas = val::undefined ();
+}
+
+static GstFlowReturn
+gst_web_compositor_aggregate_frames (
+    GstVideoAggregator *vagg, GstBuffer *outbuf)
+{
+  GstWebCompositor *self = GST_WEB_COMPOSITOR (vagg);
+  GstWebCompositorDrawData data;
+  GList *l;
+  guint i;
+
+  data.self = self;
+  data.runner = gst_web_canvas_get_runner (self->canvas);
+  data.inputs = g_array_new (FALSE, TRUE, sizeof (GstWebCompositorInput));
+  g_array_set_clear_func (
+      data.inputs, (GDestroyNotify) gst_web_compositor_input_clear);
+  data.width = GST_VIDEO_INFO_WIDTH (&vagg->info);
+  data.height = GST_VIDEO_INFO_HEIGHT (&vagg->info);
+  data.pts = GST_BUFFER_PTS (outbuf);
+  data.duration = GST_BUFFER_DURATION (outbuf);
+  data.result = NULL;
+
+  /* The sink pads are sorted by zorder, the lowest one drawn first */
+  GST_OBJECT_LOCK (vagg);
+  for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
+    GstVideoAggregatorPad *vpad = (GstVideoAggregatorPad *) l->data;
+    GstWebCompositorPad *pad = GST_WEB_COMPOSITOR_PAD (vpad);
+    GstWebCompositorInput input;
+    GstBuffer *buffer;
+    GstMemory *mem;
+
+    buffer = gst_video_aggregator_pad_get_current_buffer (vpad);
+    /* No buffer yet, a gap or fully transparent */
+    if (!buffer || gst_buffer_n_memory (buffer) == 0 || pad->alpha == 0.0)
+      continue;
+    mem = gst_buffer_peek_memory (buffer, 0);
+    if (!gst_memory_is_type (mem, GST_WEB_VIDEO_FRAME_ALLOCATOR_NAME))
+      continue;
+
+    input.video_frame = (GstWebVideoFrame *) gst_memory_ref (mem);
+    input.x = pad->xpos;
+    input.y = pad->ypos;
+    input.alpha = pad->alpha;
+    gst_web_compositor_pad_get_output_size (pad, &input.width, &input.height);
+    g_array_append_val (data.inputs, input);
+  }
+  GST_OBJECT_UNLOCK (vagg);
+
+  /* The decoders might be running on their own runners */
+  for (i = 0; i < data.inputs->len; i++) {
+    GstWebCompositorInput *input =
+        &g_array_index (data.inputs, GstWebCompositorInput, i);
+    GstWebVideoFrame *vf = input->video_frame;
+    GstWebRunner *runner = gst_web_video_frame_get_runner (vf);
+
+    if (runner != data.runner && !self->warned_foreign_runner) {
+      GST_ELEMENT_WARNING (self, STREAM, FORMAT,
+          ("Inputs on another runner are copied through the CPU"),
+          ("Use runner-mode=shared in the decoders to avoid the copy"));
+      self->warned_foreign_runner = TRUE;
+    }
+    gst_object_unref (runner);
+    input->video_frame = gst_web_video_frame_import (vf, data.runner);
+    if (!input->video_frame) {
+      GST_WARNING_OBJECT (
+          self, "Impossible to get the VideoFrame on our runner");
+    }
+    gst_memory_unref (GST_MEMORY_CAST (vf));
+  }
+
+  gst_web_runner_send_message (data.runner, gst_web_compositor_draw, &data);
+  g_array_unref (data.inputs);
+  gst_object_unref (data.runner);
+
+  if (!data.result) {
+    GST_ELEMENT_ERROR (self, RESOURCE, FAILED, (NULL),
+        ("Impossible to create the composited VideoFrame"));
+    return GST_FLOW_ERROR;
+  }
+  gst_buffer_insert_memory (outbuf, -1, GST_MEMORY_CAST (data.result));
+
+  return GST_FLOW_OK;
+}
+
+/* The memory is created when drawing */
+static GstFlowReturn
+gst_web_compositor_create_output_buffer (
+    GstVideoAggregator *vagg, GstBuffer **outbuf)
+{
+  *outbuf = gst_buffer_new ();
+
+  return GST_FLOW_OK;
+}
+
+static GstCaps *
+gst_web_compositor_update_caps (GstVideoAggregator *vagg, GstCaps *caps)
+{
+  GstCaps *template_caps;
+  GstCaps *ret;
+
+  template_caps = gst_static_pad_template_get_caps (&static_src_template);
+  ret = gst_caps_intersect (caps, template_caps);
+  gst_caps_unref (template_caps);
+
+  return ret;
+}
+
+/* Big enough for every input at its position, at the highest framerate */
+static GstCaps *
+gst_web_compositor_fixate_src_caps (GstAggregator *agg, GstCaps *caps)
+{
+  GstVideoAggregator *vagg = GST_VIDEO_AGGREGATOR (agg);
+  gint best_width = -1, best_height = -1;
+  gint best_fps_n = -1, best_fps_d = -1;
+  gdouble best_fps = 0.;
+  GstStructure *s;
+  GstCaps *ret;
+  GList *l;
+
+  ret = gst_caps_make_writable (caps);
+  s = gst_caps_get_structure (ret, 0);
+  if (gst_structure_has_field (s, "pixel-aspect-ratio"))
+    gst_structure_fixate_field_nearest_fraction (
+        s, "pixel-aspect-ratio", 1, 1);
+
+  GST_OBJECT_LOCK (vagg);
+  for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
+    GstVideoAggregatorPad *vpad = (GstVideoAggregatorPad *) l->data;
+    GstWebCompositorPad *pad = GST_WEB_COMPOSITOR_PAD (vpad);
+    gint fps_n, fps_d;
+    gint width, height;
+    gdouble cur_fps;
+
+    fps_n = GST_VIDEO_INFO_FPS_N (&vpad->info);
+    fps_d = GST_VIDEO_INFO_FPS_D (&vpad->info);
+    gst_web_compositor_pad_get_output_size (pad, &width, &height);
+    if (width <= 0 || height <= 0)
+      continue;
+
+    best_width = MAX (best_width, width + MAX (pad->xpos, 0));
+    best_height = MAX (best_height, height + MAX (pad->ypos, 0));
+
+    if (fps_d == 0)
+      cur_fps = 0.0;
+    else
+      gst_util_fraction_to_double (fps_n, fps_d, &cur_fps);
+    if (best_fps < cur_fps) {
+      best_fps = cur_fps;
+      best_fps_n = fps_n;
+      best_fps_d = fps_d;
+    }
+  }
+  GST_OBJECT_UNLOCK (vagg);
+
+  if (best_fps_n <= 0 || best_fps_d <= 0 || best_fps == 0.0) {
+    best_fps_n = 25;
+    best_fps_d = 1;
+  }
+
+  gst_structure_fixate_field_nearest_int (s, "width", best_width);
+  gst_structure_fixate_field_nearest_int (s, "height", best_height);
+  gst_structure_fixate_field_nearest_fraction (
+      s, "framerate", best_fps_n, best_fps_d);
+  ret = gst_caps_fixate (ret);
+
+  return ret;
+}
+
+/* There is no pool, the VideoFrames are created from the canvas */
+static gboolean
+gst_web_compositor_decide_allocation (GstAggregator *agg, GstQuery *query)
+{
+  return TRUE;
+}
+
+static gboolean
+gst_web_compositor_start (GstAggregator *agg)
+{
+  GstWebCompositor *self = GST_WEB_COMPOSITOR (agg);
+  GstWebRunner *runner;
+  gboolean ret = FALSE;
+
+  if (!gst_web_utils_element_ensure_canvas (
+          GST_ELEMENT (self), &self->canvas, NULL)) {
+    GST_ERROR_OBJECT (self, "Failed requesting a WebCanvas context");
+    return FALSE;
+  }
+
+  runner = gst_web_canvas_get_runner (self->canvas);
+  if (!gst_web_runner_run (runner, NULL)) {
+    GST_ERROR_OBJECT (self, "Impossible to run the runner");
+    goto done;
+  }
+  self->warned_foreign_runner = FALSE;
+
+  ret = GST_AGGREGATOR_CLASS (parent_class)->start (agg);
+done:
+  gst_object_unref (runner);
+  return ret;
+}
+
+static gboolean
+gst_web_compositor_stop (GstAggregator *agg)
+{
+  GstWebCompositor *self = GST_WEB_COMPOSITOR (agg);
+  GstWebRunner *runner;
+
+  if (self->canvas) {
+    runner = gst_web_canvas_get_runner (self->canvas);
+    gst_web_runner_send_message (runner, gst_web_compositor_teardown, self);
+    gst_object_unref (runner);
+  }
+
+  return GST_AGGREGATOR_CLASS (parent_class)->stop (agg);
+}
+
+static GstPad *
+gst_web_compositor_request_new_pad (GstElement *element,
+    GstPadTemplate *templ, const gchar *req_name, const GstCaps *caps)
+{
+  GstPad *pad;
+
+  pad = GST_ELEMENT_CLASS (parent_class)
+            ->request_new_pad (element, templ, req_name, caps);
+  if (pad) {
+    gst_child_proxy_child_added (
+        GST_CHILD_PROXY (element), G_OBJECT (pad), GST_OBJECT_NAME (pad));
+  }
+
+  return pad;
+}
+
+static void
+gst_web_compositor_release_pad (GstElement *element, GstPad *pad)
+{
+  gst_child_proxy_child_removed (
+      GST_CHILD_PROXY (element), G_OBJECT (pad), GST_OBJECT_NAME (pad));
+
+  GST_ELEMENT_CLASS (parent_class)->release_pad (element, pad);
+}
+
+static void
+gst_web_compositor_set_context (GstElement *element, GstContext *context)
+{
+  GstWebCompositor *self = GST_WEB_COMPOSITOR (element);
+
+  gst_web_utils_element_set_context (element, context, &self->canvas);
+}
+
+static gboolean
+gst_web_compositor_query (GstElement *element, GstQuery *query)
+{
+  GstWebCompositor *self = GST_WEB_COMPOSITOR (element);
+  gboolean ret = FALSE;
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CONTEXT:
+      ret = gst_web_utils_element_handle_context_query (
+          element, query, self->canvas);
+      break;
+    default:
+      break;
+  }
+
+  if (!ret)
+    ret = GST_ELEMENT_CLASS (parent_class)->query (element, query);
+
+  return ret;
+}
+
+static GObject *
+gst_web_compositor_child_proxy_get_child_by_index (
+    GstChildProxy *child_proxy, guint index)
+{
+  GstWebCompositor *self = GST_WEB_COMPOSITOR (child_proxy);
+  GObject *obj;
+
+  GST_OBJECT_LOCK (self);
+  obj = (GObject *) g_list_nth_data (GST_ELEMENT (self)->sinkpads, index);
+  if (obj)
+    gst_object_ref (obj);
+  GST_OBJECT_UNLOCK (self);
+
+  return obj;
+}
+
+static guint
+gst_web_compositor_child_proxy_get_children_count (
+    GstChildProxy *child_proxy)
+{
+  GstWebCompositor *self = GST_WEB_COMPOSITOR (child_proxy);
+  guint count;
+
+  GST_OBJECT_LOCK (self);
+  count = GST_ELEMENT (self)->numsinkpads;
+  GST_OBJECT_UNLOCK (self);
+
+  return count;
+}
+
+static void
+gst_web_compositor_child_proxy_init (gpointer g_iface, gpointer iface_data)
+{
+  GstChildProxyInterface *iface = (GstChildProxyInterface *) g_iface;
+
+  iface->get_child_by_index =
+      gst_web_compositor_child_proxy_get_child_by_index;
+  iface->get_children_count =
+      gst_web_compositor_child_proxy_get_children_count;
+}
+
+static void
+gst_web_compositor_dispose (GObject *object)
+{
+  GstWebCompositor *self = GST_WEB_COMPOSITOR (object);
+
+  gst_clear_object (&self->canvas);
+
+  G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
+static void
+gst_web_compositor_init (GstWebCompositor *self)
+{
+  self->val_canvas = val::undefined ();
+  self->val_context = val::undefined ();
+}
+
+static void
+gst_web_compositor_class_init (GstWebCompositorClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstAggregatorClass *agg_class = GST_AGGREGATOR_CLASS (klass);
+  GstVideoAggregatorClass *vagg_class = GST_VIDEO_AGGREGATOR_CLASS (klass);
+
+  gobject_class->dispose = gst_web_compositor_dispose;
+
+  element_class->request_new_pad = gst_web_compositor_request_new_pad;
+  element_class->release_pad = gst_web_compositor_release_pad;
+  element_class->set_context = gst_web_compositor_set_context;
+  element_class->query = gst_web_compositor_query;
+  gst_element_class_add_static_pad_template_with_gtype (
+      element_class, &static_sink_template, GST_TYPE_WEB_COMPOSITOR_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (
+      element_class, &static_src_template, GST_TYPE_AGGREGATOR_PAD);
+  gst_element_class_set_static_metadata (element_class, "Web Compositor",
+      "Filter/Editor/Video/Compositor",
+      "Composites VideoFrames with drawImage on an OffscreenCanvas",
+      GST_WEB_AUTHOR);
+
+  agg_class->start = gst_web_compositor_start;
+  agg_class->stop = gst_web_compositor_stop;
+  agg_class->fixate_src_caps = gst_web_compositor_fixate_src_caps;
+  agg_class->decide_allocation = gst_web_compositor_decide_allocation;
+
+  vagg_class->update_caps = gst_web_compositor_update_caps;
+  vagg_class->create_output_buffer = gst_web_compositor_create_output_buffer;
+  vagg_class->aggregate_frames = gst_web_compositor_aggregate_frames;
+
+  gst_type_mark_as_plugin_api (
+      GST_TYPE_WEB_COMPOSITOR_PAD, (GstPluginAPIFlags) 0);
+}
@@ -29,6 +29,9 @@
 #include <gst/gst.h>
 #include <gst/base/gstbasetransform.h>
 #include <gst/video/gstvideometa.h>
+#include <gst/video/video-converter.h>
+#include <gst/video/gstvideopool.h>
+#include <gst/web/gstwebsimd.h>
 #include <gst/web/gstwebutils.h>
 #include <gst/web/gstwebvideoframe.h>
 #include "gstweb.h"
@@ -43,14 +46,53 @@
       GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME,                                \
       GST_WEB_MEMORY_VIDEO_FORMATS_STR)
 
+#define DEFAULT_MAX_INFLIGHT 1
+
+enum
+{
+  PROP_0,
+  PROP_MAX_INFLIGHT,
+  PROP_LAST
+};
+
 struct _GstWebDownload
 {
   GstBaseTransform element;
 
   /*< private >*/
+  GstVideoInfo in_info;
   GstVideoInfo vinfo;
+  /* The output format is not the input one */
+  gboolean convert;
+  /* Cleared once the browser fails to convert */
+  gboolean browser_convert;
+  /* Fallback conversion, from a copy of the frame in its own format */
+  GstVideoConverter *converter;
+  GstBuffer *in_buffer;
+  GstBufferPool *pool;
+
+  guint max_inflight;
+  /* The copies in flight, in order, pushed by the src pad task */
+  GMutex lock;
+  GCond cond;
+  GQueue copies;
+  /* The task is pushing a copy already taken from the queue */
+  gboolean pushing;
+  gboolean flushing;
+  GstFlowReturn flow_ret;
 };
 
+typedef struct _GstWebDownloadCopy
+{
+  GstWebDownload *self;
+  GstBuffer *inbuf;
+  GstBuffer *outbuf;
+  GstMapInfo map;
+  gboolean mapped;
+  gboolean done;
+  gboolean result;
+} GstWebDownloadCopy;
+
 G_DECLARE_FINAL_TYPE (
     GstWebDownload, gst_web_download, GST, WEB_DOWNLOAD, GstBaseTransform)
 G_DEFINE_TYPE (GstWebDownload, gst_web_download, GST_TYPE_BASE_TRANSFORM);
@@ -66,6 +108,39 @@ static GstStaticPadTemplate gst_web_download_src_pad_template =
     GST_STATIC_PAD_TEMPLATE ("src", GST_PAD_SRC, GST_PAD_ALWAYS,
         GST_STATIC_CAPS (DEFAULT_STATIC_CAPS));
 
+/* A VideoFrame can be downloaded to any format, the browser or the
+ * fallback converts it. The structures with the @from features are copied
+ * with the @to ones and any format of @templ
+ */
+static GstCaps *
+gst_web_download_any_format (GstCaps *caps, const gchar *from,
+    const gchar *to, GstStaticPadTemplate *templ)
+{
+  GstCaps *res, *templ_caps, *tmp;
+  guint i;
+
+  tmp = gst_caps_new_empty ();
+  for (i = 0; i < gst_caps_get_size (caps); i++) {
+    GstStructure *s;
+
+    if (!gst_caps_features_contains (gst_caps_get_features (caps, i), from))
+      continue;
+
+    s = gst_structure_copy (gst_caps_get_structure (caps, i));
+    gst_structure_remove_fields (
+        s, "format", "colorimetry", "chroma-site", NULL);
+    gst_caps_append_structure_full (
+        tmp, s, gst_caps_features_from_string (to));
+  }
+
+  templ_caps = gst_static_pad_template_get_caps (templ);
+  res = gst_caps_intersect (tmp, templ_caps);
+  gst_caps_unref (templ_caps);
+  gst_caps_unref (tmp);
+
+  return res;
+}
+
 static GstCaps *
 gst_web_download_transform_caps (GstBaseTransform *bt,
     GstPadDirection direction, GstCaps *caps, GstCaps *filter)
@@ -84,11 +159,22 @@ gst_web_download_transform_caps (GstBaseTransform *bt,
         tmp, gst_caps_features_from_string (
                  GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME));
     tmp = gst_caps_merge (gst_caps_ref (caps), tmp);
+    tmp = gst_caps_merge (tmp,
+        gst_web_download_any_format (caps,
+            GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY,
+            GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME,
+            &gst_web_download_sink_pad_template));
   } else {
     tmp = gst_caps_copy (caps);
     gst_caps_set_features_simple (tmp,
         gst_caps_features_from_string (GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY));
     tmp = gst_caps_merge (gst_caps_ref (caps), tmp);
+    /* Keep the same format first, to prefer the plain copy */
+    tmp = gst_caps_merge (tmp,
+        gst_web_download_any_format (caps,
+            GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME,
+            GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY,
+            &gst_web_download_src_pad_template));
   }
 
   if (filter) {
@@ -114,17 +200,123 @@ gst_web_download_prepare_output_buffer (
     return GST_FLOW_OK;
   }
 
+  if (self->pool)
+    return gst_buffer_pool_acquire_buffer (self->pool, outbuf, NULL);
+
   *outbuf = gst_buffer_new_allocate (NULL, self->vinfo.size, NULL);
   return GST_FLOW_OK;
 }
 
+static void
+gst_web_download_clear_pool (GstWebDownload *self)
+{
+  if (!self->pool)
+    return;
+
+  gst_buffer_pool_set_active (self->pool, FALSE);
+  gst_clear_object (&self->pool);
+}
+
 static gboolean
 gst_web_download_set_caps (
     GstBaseTransform *bt, GstCaps *in_caps, GstCaps *out_caps)
 {
   GstWebDownload *self = GST_WEB_DOWNLOAD (bt);
 
-  gst_video_info_from_caps (&self->vinfo, out_caps);
+  if (!gst_video_info_from_caps (&self->in_info, in_caps) ||
+      !gst_video_info_from_caps (&self->vinfo, out_caps))
+    return FALSE;
+
+  g_clear_pointer (&self->converter, gst_video_converter_free);
+  gst_clear_buffer (&self->in_buffer);
+  self->convert = GST_VIDEO_INFO_FORMAT (&self->in_info) !=
+                  GST_VIDEO_INFO_FORMAT (&self->vinfo);
+  self->browser_convert = TRUE;
+  if (self->convert) {
+    GST_INFO_OBJECT (self, "Converting from %s to %s",
+        gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&self->in_info)),
+        gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&self->vinfo)));
+  }
+
+  /* Output buffers for the copies, at least one per copy in flight */
+  gst_web_download_clear_pool (self);
+  if (!gst_caps_is_equal (in_caps, out_caps)) {
+    GstStructure *config;
+
+    self->pool = gst_video_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (self->pool);
+    gst_buffer_pool_config_set_params (
+        config, out_caps, self->vinfo.size, self->max_inflight, 0);
+    if (!gst_buffer_pool_set_config (self->pool, config) ||
+        !gst_buffer_pool_set_active (self->pool, TRUE)) {
+      GST_ERROR_OBJECT (self, "Impossible to configure the pool");
+      gst_clear_object (&self->pool);
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/* Copies the frame in its own format and converts it in wasm, with the SIMD
+ * kernels when they handle the formats */
+static gboolean
+gst_web_download_convert (GstWebDownload *self, GstWebVideoFrame *vf,
+    GstBuffer *inbuf, GstBuffer *outbuf)
+{
+  GstVideoFrame in_frame, out_frame;
+  GstMapInfo map;
+  gboolean simd;
+  gboolean ret;
+
+  simd = gst_web_simd_can_convert (GST_VIDEO_INFO_FORMAT (&self->in_info),
+      GST_VIDEO_INFO_FORMAT (&self->vinfo));
+  if (!simd && !self->converter) {
+    self->converter =
+        gst_video_converter_new (&self->in_info, &self->vinfo, NULL);
+    if (!self->converter) {
+      GST_ERROR_OBJECT (self, "Impossible to create the converter");
+      return FALSE;
+    }
+  }
+  if (!self->in_buffer) {
+    self->in_buffer =
+        gst_buffer_new_allocate (NULL, self->in_info.size, NULL);
+  }
+
+  gst_buffer_map (self->in_buffer, &map, GST_MAP_WRITE);
+  ret = gst_web_video_frame_copy_to (vf, &self->in_info, map.data, map.size);
+  gst_buffer_unmap (self->in_buffer, &map);
+  if (!ret) {
+    GST_ERROR_OBJECT (self, "Failed to copy the frame");
+    return FALSE;
+  }
+
+  if (!gst_video_frame_map (
+          &in_frame, &self->in_info, self->in_buffer, GST_MAP_READ))
+    return FALSE;
+  if (!gst_video_frame_map (&out_frame, &self->vinfo, outbuf, GST_MAP_WRITE)) {
+    gst_video_frame_unmap (&in_frame);
+    return FALSE;
+  }
+  if (simd && !gst_web_simd_convert_frame (&in_frame, &out_frame)) {
+    GST_WARNING_OBJECT (self, "The SIMD kernel can not convert the frame, "
+        "using the video converter");
+    simd = FALSE;
+    if (!self->converter) {
+      self->converter =
+          gst_video_converter_new (&self->in_info, &self->vinfo, NULL);
+    }
+  }
+  if (!simd && self->converter)
+    gst_video_converter_frame (self->converter, &in_frame, &out_frame);
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+
+  if (!simd && !self->converter) {
+    GST_ERROR_OBJECT (self, "Impossible to create the converter");
+    return FALSE;
+  }
 
   return TRUE;
 }
@@ -136,47 +328,416 @@ gst_web_download_transform (
   GstWebVideoFrame *vf;
   GstMapInfo out_map;
   GstWebDownload *self = GST_WEB_DOWNLOAD (bt);
+  gboolean ret = FALSE;
 
   GST_DEBUG_OBJECT (self, "Transform start");
 
-  if (!gst_buffer_map (outbuf, &out_map, GST_MAP_WRITE)) {
-    GST_ERROR_OBJECT (self, "Failed to map output buffer.");
-    return GST_FLOW_ERROR;
-  }
-
   vf = (GstWebVideoFrame *) gst_buffer_get_memory (inbuf, 0);
   g_assert (vf);
-  gst_web_video_frame_copy_to (vf, &self->vinfo, out_map.data, out_map.size);
+
+  /* Let the browser convert when it can, out of wasm */
+  if (!self->convert || self->browser_convert) {
+    if (!gst_buffer_map (outbuf, &out_map, GST_MAP_WRITE)) {
+      GST_ERROR_OBJECT (self, "Failed to map output buffer.");
+      gst_memory_unref (GST_MEMORY_CAST (vf));
+      return GST_FLOW_ERROR;
+    }
+    ret = gst_web_video_frame_copy_to (
+        vf, &self->vinfo, out_map.data, out_map.size);
+    gst_buffer_unmap (outbuf, &out_map);
+
+    if (!ret && self->convert) {
+      GST_INFO_OBJECT (
+          self, "The browser can not convert, falling back to wasm");
+      self->browser_convert = FALSE;
+    }
+  }
+  if (!ret && self->convert)
+    ret = gst_web_download_convert (self, vf, inbuf, outbuf);
   gst_memory_unref (GST_MEMORY_CAST (vf));
 
+  if (!ret) {
+    GST_ELEMENT_ERROR (self, STREAM, FAILED, (NULL),
+        ("Failed to download the frame"));
+    return GST_FLOW_ERROR;
+  }
+
   gst_buffer_copy_into (
       outbuf, inbuf, GST_BUFFER_COPY_META | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
 
-  gst_buffer_unmap (outbuf, &out_map);
-
   GST_DEBUG_OBJECT (self, "Transform end");
   return GST_FLOW_OK;
 }
 
+static void
+gst_web_download_copy_free (GstWebDownloadCopy *copy)
+{
+  if (copy->mapped)
+    gst_buffer_unmap (copy->outbuf, &copy->map);
+  gst_clear_buffer (&copy->outbuf);
+  gst_buffer_unref (copy->inbuf);
+  g_free (copy);
+}
+
+/* Called from the runner of the frame */
+static void
+gst_web_download_on_copied (gboolean result, gpointer user_data)
+{
+  GstWebDownloadCopy *copy = (GstWebDownloadCopy *) user_data;
+  GstWebDownload *self = copy->self;
+
+  g_mutex_lock (&self->lock);
+  copy->done = TRUE;
+  copy->result = result;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+}
+
+/* Pushes the copies in the order they were submitted */
+static void
+gst_web_download_loop (gpointer user_data)
+{
+  GstWebDownload *self = GST_WEB_DOWNLOAD (user_data);
+  GstBaseTransform *bt = GST_BASE_TRANSFORM (self);
+  GstWebDownloadCopy *copy;
+  GstBuffer *outbuf;
+  GstFlowReturn ret;
+  gboolean ok;
+
+  g_mutex_lock (&self->lock);
+  while (!self->flushing &&
+         (!(copy = (GstWebDownloadCopy *) g_queue_peek_head (&self->copies)) ||
+             !copy->done))
+    g_cond_wait (&self->cond, &self->lock);
+  if (self->flushing) {
+    g_mutex_unlock (&self->lock);
+    gst_pad_pause_task (bt->srcpad);
+    return;
+  }
+  g_queue_pop_head (&self->copies);
+  self->pushing = TRUE;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  if (copy->mapped) {
+    gst_buffer_unmap (copy->outbuf, &copy->map);
+    copy->mapped = FALSE;
+  }
+
+  ok = copy->result;
+  if (!ok && self->convert) {
+    GstWebVideoFrame *vf;
+
+    g_mutex_lock (&self->lock);
+    if (self->browser_convert) {
+      GST_INFO_OBJECT (
+          self, "The browser can not convert, falling back to wasm");
+      self->browser_convert = FALSE;
+    }
+    g_mutex_unlock (&self->lock);
+
+    vf = (GstWebVideoFrame *) gst_buffer_get_memory (copy->inbuf, 0);
+    ok = gst_web_download_convert (self, vf, copy->inbuf, copy->outbuf);
+    gst_memory_unref (GST_MEMORY_CAST (vf));
+  }
+
+  outbuf = copy->outbuf;
+  copy->outbuf = NULL;
+  gst_web_download_copy_free (copy);
+
+  if (!ok) {
+    gst_buffer_unref (outbuf);
+    GST_ELEMENT_ERROR (self, STREAM, FAILED, (NULL),
+        ("Failed to download the frame"));
+    ret = GST_FLOW_ERROR;
+  } else {
+    ret = gst_pad_push (bt->srcpad, outbuf);
+  }
+
+  g_mutex_lock (&self->lock);
+  self->pushing = FALSE;
+  if (ret != GST_FLOW_OK)
+    self->flow_ret = ret;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (
+        self, "Pausing task, reason: %s", gst_flow_get_name (ret));
+    gst_pad_pause_task (bt->srcpad);
+    if (ok && (ret == GST_FLOW_NOT_LINKED || ret < GST_FLOW_EOS))
+      GST_ELEMENT_FLOW_ERROR (self, ret);
+  }
+}
+
+/* Waits until every copy in flight has been pushed, including the one
+ * being pushed by the task, so nothing overtakes it
+ */
+static void
+gst_web_download_drain (GstWebDownload *self)
+{
+  g_mutex_lock (&self->lock);
+  while (!self->flushing && self->flow_ret == GST_FLOW_OK &&
+         (!g_queue_is_empty (&self->copies) || self->pushing))
+    g_cond_wait (&self->cond, &self->lock);
+  g_mutex_unlock (&self->lock);
+}
+
+/* Drops the copies in flight, once the browser is done with them */
+static void
+gst_web_download_drop_copies (GstWebDownload *self)
+{
+  GstWebDownloadCopy *copy;
+
+  g_mutex_lock (&self->lock);
+  while ((copy = (GstWebDownloadCopy *) g_queue_pop_head (&self->copies))) {
+    while (!copy->done)
+      g_cond_wait (&self->cond, &self->lock);
+    g_mutex_unlock (&self->lock);
+    gst_web_download_copy_free (copy);
+    g_mutex_lock (&self->lock);
+  }
+  g_mutex_unlock (&self->lock);
+}
+
+static gboolean
+gst_web_download_is_pipelined (GstWebDownload *self)
+{
+  return self->max_inflight > 1;
+}
+
+/* Starts the copy of the queued buffer and returns without any output, the
+ * src pad task pushes it once done
+ */
+static GstFlowReturn
+gst_web_download_generate_output (GstBaseTransform *bt, GstBuffer **outbuf)
+{
+  GstWebDownload *self = GST_WEB_DOWNLOAD (bt);
+  GstWebDownloadCopy *copy;
+  GstWebVideoFrame *vf;
+  GstBuffer *inbuf;
+  GstFlowReturn ret;
+  gboolean browser_convert;
+
+  if (!gst_web_download_is_pipelined (self) ||
+      gst_base_transform_is_passthrough (bt)) {
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->generate_output (
+        bt, outbuf);
+  }
+
+  *outbuf = NULL;
+  inbuf = bt->queued_buf;
+  bt->queued_buf = NULL;
+  if (!inbuf)
+    return GST_FLOW_OK;
+
+  g_mutex_lock (&self->lock);
+  while (!self->flushing && self->flow_ret == GST_FLOW_OK &&
+         g_queue_get_length (&self->copies) >= self->max_inflight) {
+    GST_LOG_OBJECT (self, "Reached the copies limit, waiting");
+    g_cond_wait (&self->cond, &self->lock);
+  }
+  ret = self->flushing ? GST_FLOW_FLUSHING : self->flow_ret;
+  browser_convert = !self->convert || self->browser_convert;
+  g_mutex_unlock (&self->lock);
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_unref (inbuf);
+    return ret;
+  }
+
+  copy = g_new0 (GstWebDownloadCopy, 1);
+  copy->self = self;
+  copy->inbuf = inbuf;
+  ret = gst_buffer_pool_acquire_buffer (self->pool, &copy->outbuf, NULL);
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (self, "Failed to acquire a buffer: %s",
+        gst_flow_get_name (ret));
+    gst_web_download_copy_free (copy);
+    return ret;
+  }
+  gst_buffer_copy_into (copy->outbuf, inbuf,
+      GST_BUFFER_COPY_META | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+
+  if (browser_convert) {
+    gst_buffer_map (copy->outbuf, &copy->map, GST_MAP_WRITE);
+    copy->mapped = TRUE;
+  } else {
+    /* Converted in wasm by the task */
+    copy->done = TRUE;
+  }
+
+  g_mutex_lock (&self->lock);
+  g_queue_push_tail (&self->copies, copy);
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  if (browser_convert) {
+    vf = (GstWebVideoFrame *) gst_buffer_get_memory (inbuf, 0);
+    gst_web_video_frame_copy_to_async (vf, &self->vinfo, copy->map.data,
+        copy->map.size, gst_web_download_on_copied, copy);
+    gst_memory_unref (GST_MEMORY_CAST (vf));
+  }
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+gst_web_download_sink_event (GstBaseTransform *bt, GstEvent *event)
+{
+  GstWebDownload *self = GST_WEB_DOWNLOAD (bt);
+  gboolean ret;
+
+  if (!gst_web_download_is_pipelined (self))
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (bt, event);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_START:
+      g_mutex_lock (&self->lock);
+      self->flushing = TRUE;
+      g_cond_broadcast (&self->cond);
+      g_mutex_unlock (&self->lock);
+      ret = GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (bt, event);
+      gst_pad_pause_task (bt->srcpad);
+      return ret;
+    case GST_EVENT_FLUSH_STOP:
+      gst_web_download_drop_copies (self);
+      g_mutex_lock (&self->lock);
+      self->flushing = FALSE;
+      self->flow_ret = GST_FLOW_OK;
+      g_mutex_unlock (&self->lock);
+      ret = GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (bt, event);
+      gst_pad_start_task (bt->srcpad, gst_web_download_loop, self, NULL);
+      return ret;
+    default:
+      /* Keep the events in order with the copies in flight */
+      if (GST_EVENT_IS_SERIALIZED (event))
+        gst_web_download_drain (self);
+      break;
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (bt, event);
+}
+
+static gboolean
+gst_web_download_start (GstBaseTransform *bt)
+{
+  GstWebDownload *self = GST_WEB_DOWNLOAD (bt);
+
+  self->flushing = FALSE;
+  self->flow_ret = GST_FLOW_OK;
+  if (gst_web_download_is_pipelined (self))
+    return gst_pad_start_task (bt->srcpad, gst_web_download_loop, self, NULL);
+
+  return TRUE;
+}
+
+static gboolean
+gst_web_download_stop (GstBaseTransform *bt)
+{
+  GstWebDownload *self = GST_WEB_DOWNLOAD (bt);
+
+  g_mutex_lock (&self->lock);
+  self->flushing = TRUE;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+  gst_pad_stop_task (bt->srcpad);
+  gst_web_download_drop_copies (self);
+
+  g_clear_pointer (&self->converter, gst_video_converter_free);
+  gst_clear_buffer (&self->in_buffer);
+  gst_web_download_clear_pool (self);
+
+  return TRUE;
+}
+
+static void
+gst_web_download_set_property (
+    GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  GstWebDownload *self = GST_WEB_DOWNLOAD (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_MAX_INFLIGHT:
+      self->max_inflight = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gst_web_download_get_property (
+    GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  GstWebDownload *self = GST_WEB_DOWNLOAD (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_MAX_INFLIGHT:
+      g_value_set_uint (value, self->max_inflight);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gst_web_download_finalize (GObject *object)
+{
+  GstWebDownload *self = GST_WEB_DOWNLOAD (object);
+
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_web_download_init (GstWebDownload *self)
 {
   gst_base_transform_set_prefer_passthrough (GST_BASE_TRANSFORM (self), TRUE);
+  self->max_inflight = DEFAULT_MAX_INFLIGHT;
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+  g_queue_init (&self->copies);
 }
 
 static void
 gst_web_download_class_init (GstWebDownloadClass *klass)
 {
+  GObjectClass *gobject_class;
   GstBaseTransformClass *gstbasetransform_class;
   GstElementClass *gstelement_class;
 
+  gobject_class = (GObjectClass *) klass;
   gstbasetransform_class = (GstBaseTransformClass *) klass;
   gstelement_class = (GstElementClass *) klass;
 
+  gobject_class->set_property = gst_web_download_set_property;
+  gobject_class->get_property = gst_web_download_get_property;
+  gobject_class->finalize = gst_web_download_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_MAX_INFLIGHT,
+      g_param_spec_uint ("max-inflight", "Max in flight",
+          "Maximum amount of frames being copied at the same time, pushed "
+          "in order from a task. 1 copies one frame at a time",
+          1, G_MAXUINT, DEFAULT_MAX_INFLIGHT,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+              G_PARAM_STATIC_STRINGS));
+
   gstbasetransform_class->transform_caps = gst_web_download_transform_caps;
   gstbasetransform_class->set_caps = gst_web_download_set_caps;
   gstbasetransform_class->passthrough_on_same_caps = TRUE;
   gstbasetransform_class->transform = gst_web_download_transform;
+  gstbasetransform_class->start = gst_web_download_start;
+  gstbasetransform_class->stop = gst_web_download_stop;
+  gstbasetransform_class->sink_event = gst_web_download_sink_event;
+  gstbasetransform_class->generate_output = gst_web_download_generate_output;
   gstbasetransform_class->prepare_output_buffer =
       gst_web_download_prepare_output_buffer;
 
@@ -0,0 +1,127 @@
+/*
+ * GStreamer - gst.wasm WebGLRunner
+ *
+ * Copyright 2025 Fluendo S.A.
+ * @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * A GstWebRunner whose thread is the one of a GstGLContext. JS objects are
+ * local to the thread that created them, so an element producing GL textures
+ * from JS objects, like the VideoFrames of WebCodecs, needs to create them
+ * on the GL thread. This runner lets such an element keep using the
+ * GstWebRunner API regardless of where it runs.
+ *
+ * The thread is owned by the GL context, gst_web_runner_run() must not be
+ * called on it.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstwebglrunner.h"
+
+GST_DEBUG_CATEGORY_STATIC (web_gl_runner_debug);
+#define GST_CAT_DEFAULT web_gl_runner_debug
+
+G_DEFINE_TYPE_WITH_CODE (GstWebGLRunner, gst_web_gl_runner,
+    GST_TYPE_WEB_RUNNER,
+    GST_DEBUG_CATEGORY_INIT (
+        web_gl_runner_debug, "webglrunner", 0, "Web Runner on a GL thread"));
+
+static GThread *
+gst_web_gl_runner_create_thread (
+    GstWebRunner *runner, const gchar *name, GThreadFunc run)
+{
+  GST_ERROR_OBJECT (runner, "The GL context owns the thread");
+
+  return NULL;
+}
+
+static void
+gst_web_gl_runner_send_message (
+    GstWebRunner *runner, GstWebRunnerCB callback, gpointer data)
+{
+  GstWebGLRunner *self = GST_WEB_GL_RUNNER (runner);
+
+  gst_gl_window_send_message (self->window, (GstGLWindowCB) callback, data);
+}
+
+static void
+gst_web_gl_runner_send_message_async (GstWebRunner *runner,
+    GstWebRunnerCB callback, gpointer data, GDestroyNotify destroy)
+{
+  GstWebGLRunner *self = GST_WEB_GL_RUNNER (runner);
+
+  gst_gl_window_send_message_async (
+      self->window, (GstGLWindowCB) callback, data, destroy);
+}
+
+static void
+gst_web_gl_runner_finalize (GObject *object)
+{
+  GstWebGLRunner *self = GST_WEB_GL_RUNNER (object);
+
+  gst_clear_object (&self->window);
+  gst_clear_object (&self->context);
+
+  G_OBJECT_CLASS (gst_web_gl_runner_parent_class)->finalize (object);
+}
+
+static void
+gst_web_gl_runner_init (GstWebGLRunner *self)
+{
+}
+
+static void
+gst_web_gl_runner_class_init (GstWebGLRunnerClass *klass)
+{
+  GstWebRunnerClass *runner_class = GST_WEB_RUNNER_CLASS (klass);
+
+  runner_class->create_thread =
+      GST_DEBUG_FUNCPTR (gst_web_gl_runner_create_thread);
+  runner_class->send_message =
+      GST_DEBUG_FUNCPTR (gst_web_gl_runner_send_message);
+  runner_class->send_message_async =
+      GST_DEBUG_FUNCPTR (gst_web_gl_runner_send_message_async);
+
+  G_OBJECT_CLASS (klass)->finalize = gst_web_gl_runner_finalize;
+}
+
+/**
+ * gst_web_gl_runner_new:
+ * @context: the #GstGLContext whose thread will run the messages
+ *
+ * Returns: (transfer full): a new #GstWebRunner running on the thread of
+ * @context
+ */
+GstWebRunner *
+gst_web_gl_runner_new (GstGLContext *context)
+{
+  GstWebGLRunner *self;
+
+  g_return_val_if_fail (GST_IS_GL_CONTEXT (context), NULL);
+
+  self = g_object_new (GST_TYPE_WEB_GL_RUNNER, NULL);
+  self->context = gst_object_ref (context);
+  self->window = gst_gl_context_get_window (context);
+  gst_object_ref_sink (self);
+
+  return GST_WEB_RUNNER (self);
+}
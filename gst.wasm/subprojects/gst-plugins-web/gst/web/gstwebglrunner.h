@@ -0,0 +1,60 @@
+/*
+ * GStreamer - gst.wasm WebGLRunner
+ *
+ * Copyright 2025 Fluendo S.A.
+ * @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __GST_WEB_GL_RUNNER_H__
+#define __GST_WEB_GL_RUNNER_H__
+
+#include <gst/gst.h>
+#include <gst/gl/gl.h>
+#include <gst/web/gstwebrunner.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_WEB_GL_RUNNER (gst_web_gl_runner_get_type ())
+#define GST_WEB_GL_RUNNER(obj)                                                \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_WEB_GL_RUNNER, GstWebGLRunner))
+#define GST_IS_WEB_GL_RUNNER(obj)                                             \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_WEB_GL_RUNNER))
+
+typedef struct _GstWebGLRunner GstWebGLRunner;
+typedef struct _GstWebGLRunnerClass GstWebGLRunnerClass;
+
+struct _GstWebGLRunner
+{
+  GstWebRunner base;
+
+  /*< private >*/
+  GstGLContext *context;
+  GstGLWindow *window;
+};
+
+struct _GstWebGLRunnerClass
+{
+  GstWebRunnerClass base;
+};
+
+GType gst_web_gl_runner_get_type (void);
+GstWebRunner *gst_web_gl_runner_new (GstGLContext *context);
+
+G_END_DECLS
+
+#endif /* __GST_WEB_GL_RUNNER_H__ */
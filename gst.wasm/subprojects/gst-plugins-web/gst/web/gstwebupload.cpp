@@ -30,6 +30,7 @@
 #include <gst/gst.h>
 #include <gst/base/gstbasetransform.h>
 #include <gst/video/gstvideometa.h>
+#include <gst/web/gstwebsimd.h>
 #include <gst/web/gstwebutils.h>
 #include <gst/web/gstwebvideoframe.h>
 #include "gstweb.h"
@@ -44,13 +45,36 @@
       GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME,                                \
       GST_WEB_MEMORY_VIDEO_FORMATS_STR)
 
+/* The formats a VideoFrame can not be created from, unpacked in wasm */
+#define UNPACK_STATIC_CAPS GST_VIDEO_CAPS_MAKE ("I420_10LE")
+
+#define DEFAULT_MAX_INFLIGHT 1
+
+enum
+{
+  PROP_0,
+  PROP_MAX_INFLIGHT,
+  PROP_LAST
+};
+
 struct _GstWebUpload
 {
   GstBaseTransform element;
 
   /*< private >*/
+  GstVideoInfo in_info;
   GstVideoInfo vinfo;
+  gboolean unpack;
   GstWebCanvas *canvas;
+
+  guint max_inflight;
+  /* The uploads in flight, in order */
+  GMutex lock;
+  GCond cond;
+  GQueue uploads;
+  gboolean flushing;
+  /* The flow return of the last push of an event, for the next buffer */
+  GstFlowReturn flow_ret;
 };
 
 G_DECLARE_FINAL_TYPE (
@@ -62,12 +86,45 @@ GST_DEBUG_CATEGORY_STATIC (web_upload_debug);
 
 static GstStaticPadTemplate gst_web_upload_sink_pad_template =
     GST_STATIC_PAD_TEMPLATE ("sink", GST_PAD_SINK, GST_PAD_ALWAYS,
-        GST_STATIC_CAPS (DEFAULT_STATIC_CAPS));
+        GST_STATIC_CAPS (DEFAULT_STATIC_CAPS ";" UNPACK_STATIC_CAPS));
 
 static GstStaticPadTemplate gst_web_upload_src_pad_template =
     GST_STATIC_PAD_TEMPLATE ("src", GST_PAD_SRC, GST_PAD_ALWAYS,
         GST_STATIC_CAPS (DEFAULT_STATIC_CAPS));
 
+/* The structures of @caps with the @from features and a format that can be
+ * @from_format, copied with the @to features and @to_format
+ */
+static GstCaps *
+gst_web_upload_unpack_format (GstCaps *caps, const gchar *from,
+    const gchar *from_format, const gchar *to, const gchar *to_format)
+{
+  GstCaps *res;
+  guint i;
+
+  res = gst_caps_new_empty ();
+  for (i = 0; i < gst_caps_get_size (caps); i++) {
+    GstStructure *s = gst_caps_get_structure (caps, i);
+    GstStructure *tmp;
+
+    if (!gst_caps_features_contains (gst_caps_get_features (caps, i), from))
+      continue;
+
+    tmp = gst_structure_copy (s);
+    gst_structure_set (tmp, "format", G_TYPE_STRING, from_format, NULL);
+    if (!gst_structure_can_intersect (s, tmp)) {
+      gst_structure_free (tmp);
+      continue;
+    }
+    gst_structure_set (tmp, "format", G_TYPE_STRING, to_format, NULL);
+    gst_structure_remove_fields (tmp, "colorimetry", "chroma-site", NULL);
+    gst_caps_append_structure_full (
+        res, tmp, gst_caps_features_from_string (to));
+  }
+
+  return res;
+}
+
 static GstCaps *
 gst_web_upload_transform_caps (GstBaseTransform *bt,
     GstPadDirection direction, GstCaps *caps, GstCaps *filter)
@@ -87,6 +144,17 @@ gst_web_upload_transform_caps (GstBaseTransform *bt,
   tmp = gst_caps_copy (caps);
   gst_caps_set_features_simple (tmp, gst_caps_features_from_string (mem));
   tmp = gst_caps_merge (gst_caps_ref (caps), tmp);
+  if (direction == GST_PAD_SRC) {
+    tmp = gst_caps_merge (tmp,
+        gst_web_upload_unpack_format (caps,
+            GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME, "I420",
+            GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY, "I420_10LE"));
+  } else {
+    tmp = gst_caps_merge (tmp,
+        gst_web_upload_unpack_format (caps,
+            GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY, "I420_10LE",
+            GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME, "I420"));
+  }
 
   if (filter) {
     res = gst_caps_intersect_full (filter, tmp, GST_CAPS_INTERSECT_FIRST);
@@ -119,32 +187,52 @@ gst_web_upload_set_caps (
 {
   GstWebUpload *self = GST_WEB_UPLOAD (bt);
 
-  gst_video_info_from_caps (&self->vinfo, out_caps);
+  if (!gst_video_info_from_caps (&self->in_info, in_caps) ||
+      !gst_video_info_from_caps (&self->vinfo, out_caps))
+    return FALSE;
+
+  self->unpack = GST_VIDEO_INFO_FORMAT (&self->in_info) !=
+                 GST_VIDEO_INFO_FORMAT (&self->vinfo);
+  if (self->unpack) {
+    GST_INFO_OBJECT (self, "Unpacking from %s to %s",
+        gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&self->in_info)),
+        gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&self->vinfo)));
+  }
 
   return TRUE;
 }
 
-static val
-gst_web_upload_create_video_frame(val memoryView, GstVideoInfo *vinfo)
+/* Unpacks @inbuf into a new buffer of the format of the VideoFrame, with the
+ * SIMD kernels */
+static GstBuffer *
+gst_web_upload_unpack (GstWebUpload *self, GstBuffer *inbuf)
 {
-    val layout = val::array();
-
-    for (int i = 0; i < vinfo->finfo->n_planes; i++) {
-      layout.set(i, val::object());
-      layout[i].set("offset", vinfo->offset[i]);
-      layout[i].set("stride", vinfo->stride[i]);
-    }
-
-    val options = val::object();
-    options.set("format",
-        val(gst_web_utils_video_format_to_web_format (vinfo->finfo->format)));
-    options.set("codedWidth", vinfo->width);
-    options.set("codedHeight", vinfo->height);
-    options.set("layout", layout);
-    options.set("data", memoryView);
-    options.set("timestamp", 0);
+  GstVideoFrame in_frame, out_frame;
+  GstBuffer *outbuf;
+  gboolean ret;
+
+  outbuf = gst_buffer_new_allocate (NULL, self->vinfo.size, NULL);
+  if (!gst_video_frame_map (&in_frame, &self->in_info, inbuf, GST_MAP_READ)) {
+    gst_buffer_unref (outbuf);
+    return NULL;
+  }
+  if (!gst_video_frame_map (&out_frame, &self->vinfo, outbuf, GST_MAP_WRITE)) {
+    gst_video_frame_unmap (&in_frame);
+    gst_buffer_unref (outbuf);
+    return NULL;
+  }
+  ret = gst_web_simd_convert_frame (&in_frame, &out_frame);
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+  if (!ret) {
+    gst_buffer_unref (outbuf);
+    return NULL;
+  }
 
-    return val::global("VideoFrame").new_(memoryView, options);
+  gst_buffer_copy_into (outbuf, inbuf,
+      GstBufferCopyFlags (GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS),
+      0, -1);
+  return outbuf;
 }
 
 struct GstWebUploadMKVFData
@@ -153,6 +241,9 @@ struct GstWebUploadMKVFData
    GstBuffer *inbuf;
    GstWebUpload *self;
    GstWebVideoFrame *memory;
+   /* For the uploads in flight */
+   GstBuffer *outbuf;
+   gboolean done;
 };
 
 static void
@@ -160,19 +251,19 @@ gst_web_upload_make_video_frame (gpointer data)
 {
   GstMapInfo map;
   val video_frame;
-  val buffer_data;
-  val image_data_data;
   GstWebUploadMKVFData *mkvf_data = (GstWebUploadMKVFData *)data;
   GstWebUpload *self = mkvf_data->self;
 
   gst_buffer_map (mkvf_data->inbuf, &map, GST_MAP_READ);
-  buffer_data = val (typed_memory_view (map.size, map.data));
-  image_data_data = val::global ("Uint8ClampedArray").new_ (buffer_data);
-
-  video_frame = gst_web_upload_create_video_frame (image_data_data, &self->vinfo);
-
+  video_frame = gst_web_utils_video_frame_new (
+      mkvf_data->inbuf, &self->vinfo, map.data, map.size);
   mkvf_data->memory = gst_web_video_frame_wrap (video_frame, mkvf_data->runner);
   gst_buffer_unmap (mkvf_data->inbuf, &map);
+
+  g_mutex_lock (&self->lock);
+  mkvf_data->done = TRUE;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
 }
 
 static GstFlowReturn
@@ -183,14 +274,25 @@ gst_web_upload_transform (
 
   GST_DEBUG_OBJECT (self, "Transform start");
 
-  GstWebUploadMKVFData mkvf_data;
+  GstWebUploadMKVFData mkvf_data = {};
   mkvf_data.runner = gst_web_canvas_get_runner (self->canvas);
   mkvf_data.inbuf = inbuf;
   mkvf_data.self = self;
+  if (self->unpack) {
+    mkvf_data.inbuf = gst_web_upload_unpack (self, inbuf);
+    if (!mkvf_data.inbuf) {
+      GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+          ("Impossible to unpack the frame"));
+      gst_object_unref (mkvf_data.runner);
+      return GST_FLOW_ERROR;
+    }
+  }
   
   gst_web_runner_send_message (
      mkvf_data.runner, gst_web_upload_make_video_frame, &mkvf_data);
   gst_object_unref (mkvf_data.runner);
+  if (self->unpack)
+    gst_buffer_unref (mkvf_data.inbuf);
 
   gst_buffer_insert_memory (outbuf, -1, GST_MEMORY_CAST (mkvf_data.memory));
   gst_buffer_copy_into (
@@ -201,6 +303,236 @@ gst_web_upload_transform (
   return GST_FLOW_OK;
 }
 
+static void
+gst_web_upload_mkvf_data_free (GstWebUploadMKVFData *mkvf_data)
+{
+  if (mkvf_data->memory)
+    gst_memory_unref (GST_MEMORY_CAST (mkvf_data->memory));
+  gst_clear_buffer (&mkvf_data->outbuf);
+  gst_buffer_unref (mkvf_data->inbuf);
+  gst_object_unref (mkvf_data->runner);
+  g_free (mkvf_data);
+}
+
+/* Waits for the oldest upload and returns its output buffer, NULL when
+ * flushing */
+static GstBuffer *
+gst_web_upload_pop (GstWebUpload *self)
+{
+  GstWebUploadMKVFData *mkvf_data;
+  GstBuffer *outbuf;
+
+  g_mutex_lock (&self->lock);
+  mkvf_data = (GstWebUploadMKVFData *) g_queue_peek_head (&self->uploads);
+  while (!self->flushing && mkvf_data && !mkvf_data->done)
+    g_cond_wait (&self->cond, &self->lock);
+  if (self->flushing || !mkvf_data) {
+    g_mutex_unlock (&self->lock);
+    return NULL;
+  }
+  g_queue_pop_head (&self->uploads);
+  g_mutex_unlock (&self->lock);
+
+  outbuf = mkvf_data->outbuf;
+  mkvf_data->outbuf = NULL;
+  gst_buffer_insert_memory (outbuf, -1, GST_MEMORY_CAST (mkvf_data->memory));
+  mkvf_data->memory = NULL;
+  gst_web_upload_mkvf_data_free (mkvf_data);
+
+  return outbuf;
+}
+
+/* Drops the uploads in flight, once they are done */
+static void
+gst_web_upload_drop_uploads (GstWebUpload *self)
+{
+  GstWebUploadMKVFData *mkvf_data;
+
+  g_mutex_lock (&self->lock);
+  while ((mkvf_data =
+              (GstWebUploadMKVFData *) g_queue_pop_head (&self->uploads))) {
+    while (!mkvf_data->done)
+      g_cond_wait (&self->cond, &self->lock);
+    g_mutex_unlock (&self->lock);
+    gst_web_upload_mkvf_data_free (mkvf_data);
+    g_mutex_lock (&self->lock);
+  }
+  g_mutex_unlock (&self->lock);
+}
+
+/* Submits the upload of the queued buffer without waiting for it, and
+ * outputs the oldest one once max-inflight uploads are in flight. Upstream
+ * prepares the next buffers meanwhile
+ */
+static GstFlowReturn
+gst_web_upload_generate_output (GstBaseTransform *bt, GstBuffer **outbuf)
+{
+  GstWebUpload *self = GST_WEB_UPLOAD (bt);
+  GstWebUploadMKVFData *mkvf_data;
+  GstFlowReturn ret;
+  GstBuffer *inbuf;
+  GstBuffer *output;
+  guint max_inflight;
+  gboolean full;
+
+  /* A push made while handling an event failed */
+  g_mutex_lock (&self->lock);
+  ret = self->flow_ret;
+  g_mutex_unlock (&self->lock);
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (self, "Returning the flow of the previous push: %s",
+        gst_flow_get_name (ret));
+    *outbuf = NULL;
+    gst_clear_buffer (&bt->queued_buf);
+    return ret;
+  }
+
+  GST_OBJECT_LOCK (self);
+  max_inflight = self->max_inflight;
+  GST_OBJECT_UNLOCK (self);
+
+  if (max_inflight <= 1 || gst_base_transform_is_passthrough (bt))
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->generate_output (
+        bt, outbuf);
+
+  *outbuf = NULL;
+  inbuf = bt->queued_buf;
+  bt->queued_buf = NULL;
+  if (!inbuf)
+    return GST_FLOW_OK;
+
+  /* The metas of the original buffer, the unpacked one has none */
+  output = gst_buffer_new ();
+  gst_buffer_copy_into (output, inbuf,
+      GstBufferCopyFlags (GST_BUFFER_COPY_META | GST_BUFFER_COPY_TIMESTAMPS),
+      0, -1);
+  if (self->unpack) {
+    GstBuffer *unpacked = gst_web_upload_unpack (self, inbuf);
+
+    gst_buffer_unref (inbuf);
+    if (!unpacked) {
+      gst_buffer_unref (output);
+      GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+          ("Impossible to unpack the frame"));
+      return GST_FLOW_ERROR;
+    }
+    inbuf = unpacked;
+  }
+
+  mkvf_data = g_new0 (GstWebUploadMKVFData, 1);
+  mkvf_data->runner = gst_web_canvas_get_runner (self->canvas);
+  mkvf_data->inbuf = inbuf;
+  mkvf_data->self = self;
+  mkvf_data->outbuf = output;
+
+  g_mutex_lock (&self->lock);
+  g_queue_push_tail (&self->uploads, mkvf_data);
+  full = g_queue_get_length (&self->uploads) >= max_inflight;
+  g_mutex_unlock (&self->lock);
+
+  gst_web_runner_send_message_async (
+      mkvf_data->runner, gst_web_upload_make_video_frame, mkvf_data, NULL);
+
+  if (!full)
+    return GST_FLOW_OK;
+
+  *outbuf = gst_web_upload_pop (self);
+  return *outbuf ? GST_FLOW_OK : GST_FLOW_FLUSHING;
+}
+
+static gboolean
+gst_web_upload_sink_event (GstBaseTransform *bt, GstEvent *event)
+{
+  GstWebUpload *self = GST_WEB_UPLOAD (bt);
+  GstBuffer *outbuf;
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_START:
+      g_mutex_lock (&self->lock);
+      self->flushing = TRUE;
+      g_cond_broadcast (&self->cond);
+      g_mutex_unlock (&self->lock);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      gst_web_upload_drop_uploads (self);
+      g_mutex_lock (&self->lock);
+      self->flushing = FALSE;
+      self->flow_ret = GST_FLOW_OK;
+      g_mutex_unlock (&self->lock);
+      break;
+    default:
+      /* Keep the events in order with the uploads in flight. A failed push
+       * is returned for the next buffer, the rest of the uploads are
+       * dropped */
+      if (GST_EVENT_IS_SERIALIZED (event)) {
+        while ((outbuf = gst_web_upload_pop (self))) {
+          GstFlowReturn ret = gst_pad_push (bt->srcpad, outbuf);
+
+          if (ret != GST_FLOW_OK) {
+            GST_DEBUG_OBJECT (
+                self, "Failed to push: %s", gst_flow_get_name (ret));
+            g_mutex_lock (&self->lock);
+            self->flow_ret = ret;
+            g_mutex_unlock (&self->lock);
+            gst_web_upload_drop_uploads (self);
+            break;
+          }
+        }
+      }
+      break;
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (bt, event);
+}
+
+static gboolean
+gst_web_upload_stop (GstBaseTransform *bt)
+{
+  GstWebUpload *self = GST_WEB_UPLOAD (bt);
+
+  gst_web_upload_drop_uploads (self);
+  self->flushing = FALSE;
+  self->flow_ret = GST_FLOW_OK;
+
+  return TRUE;
+}
+
+static void
+gst_web_upload_set_property (
+    GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  GstWebUpload *self = GST_WEB_UPLOAD (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_MAX_INFLIGHT:
+      self->max_inflight = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gst_web_upload_get_property (
+    GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  GstWebUpload *self = GST_WEB_UPLOAD (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_MAX_INFLIGHT:
+      g_value_set_uint (value, self->max_inflight);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
 static gboolean
 gst_web_upload_start (GstBaseTransform * bt)
 {
@@ -259,6 +591,11 @@ static void
 gst_web_upload_init (GstWebUpload *self)
 {
   gst_base_transform_set_prefer_passthrough (GST_BASE_TRANSFORM (self), TRUE);
+  self->max_inflight = DEFAULT_MAX_INFLIGHT;
+  self->flow_ret = GST_FLOW_OK;
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+  g_queue_init (&self->uploads);
 }
 
 static void
@@ -273,6 +610,17 @@ gst_web_upload_dispose (GObject *gobj)
   G_OBJECT_CLASS (parent_class)->dispose (gobj);
 }
 
+static void
+gst_web_upload_finalize (GObject *gobj)
+{
+  GstWebUpload *self = GST_WEB_UPLOAD (gobj);
+
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (gobj);
+}
+
 static void
 gst_web_upload_class_init (GstWebUploadClass *klass)
 {
@@ -292,6 +640,9 @@ gst_web_upload_class_init (GstWebUploadClass *klass)
       gst_web_upload_prepare_output_buffer;
   gstbasetransform_class->start =
       gst_web_upload_start;
+  gstbasetransform_class->stop = gst_web_upload_stop;
+  gstbasetransform_class->sink_event = gst_web_upload_sink_event;
+  gstbasetransform_class->generate_output = gst_web_upload_generate_output;
 
   gstelement_class->query = gst_web_upload_query;
   gstelement_class->set_context = gst_web_upload_set_context;
@@ -306,6 +657,17 @@ gst_web_upload_class_init (GstWebUploadClass *klass)
       gstelement_class, &gst_web_upload_sink_pad_template);
 
   gobject_class->dispose = gst_web_upload_dispose;
+  gobject_class->finalize = gst_web_upload_finalize;
+  gobject_class->set_property = gst_web_upload_set_property;
+  gobject_class->get_property = gst_web_upload_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_MAX_INFLIGHT,
+      g_param_spec_uint ("max-inflight", "Max in flight",
+          "Maximum amount of frames being uploaded at the same time. 1 "
+          "uploads one frame at a time, waiting for it",
+          1, G_MAXUINT, DEFAULT_MAX_INFLIGHT,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+                         G_PARAM_STATIC_STRINGS)));
 
   GST_DEBUG_CATEGORY_INIT (
       web_upload_debug, "webupload", 0, "WebCodecs Video Decoder");
@@ -0,0 +1,595 @@
+/*
+ * GStreamer - gst.wasm WebVideoScale source
+ *
+ * Copyright 2025 Fluendo S.A.
+ * @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * SECTION:element-webvideoscale
+ *
+ * Scales VideoFrames without leaving the browser: the frame is drawn with
+ * drawImage() on an OffscreenCanvas of the runner and a new VideoFrame is
+ * created from it. Any format can be scaled, the scaled frames are RGBA, so
+ * it converts to RGBA too. Frames of the same size and format are passed
+ * through.
+ *
+ * The input is expected to be on the runner of the canvas, as the decoders
+ * with runner-mode=shared. VideoFrames can not be shared among runners, so
+ * frames from another runner are copied through the wasm memory before
+ * being scaled, and a warning is posted.
+ *
+ * The output size is negotiated with downstream, keeping the display
+ * aspect ratio when only one dimension is given. webcanvassink prefers
+ * the size of its canvas, so the frames are never bigger than needed.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 videotestsrc ! video/x-raw,width=1920,height=1080 !
+ *     webupload ! webvideoscale !
+ *     video/x-raw(memory:WebVideoFrame),width=640,height=360 !
+ *     webcanvassink
+ * ]|
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/base/gstbasetransform.h>
+#include <gst/video/video.h>
+#include <gst/web/gstwebutils.h>
+#include <gst/web/gstwebvideoframe.h>
+#include "gstweb.h"
+#include "gstwebvideoscale.h"
+
+#define GST_TYPE_WEB_VIDEO_SCALE (gst_web_video_scale_get_type ())
+#define GST_CAT_DEFAULT web_video_scale_debug
+#define parent_class gst_web_video_scale_parent_class
+
+#define DEFAULT_METHOD GST_WEB_VIDEO_SCALE_METHOD_LOW
+
+/* The format of a VideoFrame created from a canvas */
+#define SCALED_FORMAT "RGBA"
+
+#define DEFAULT_STATIC_CAPS                                                   \
+  GST_VIDEO_CAPS_MAKE_WITH_FEATURES (                                         \
+      GST_CAPS_FEATURE_MEMORY_WEB_VIDEO_FRAME,                                \
+      GST_WEB_MEMORY_VIDEO_FORMATS_STR)
+
+/* The imageSmoothingQuality of the canvas, which is what resizeQuality of
+ * createImageBitmap() does */
+typedef enum
+{
+  GST_WEB_VIDEO_SCALE_METHOD_PIXELATED,
+  GST_WEB_VIDEO_SCALE_METHOD_LOW,
+  GST_WEB_VIDEO_SCALE_METHOD_MEDIUM,
+  GST_WEB_VIDEO_SCALE_METHOD_HIGH,
+} GstWebVideoScaleMethod;
+
+#define GST_TYPE_WEB_VIDEO_SCALE_METHOD                                       \
+  (gst_web_video_scale_method_get_type ())
+
+enum
+{
+  PROP_0,
+  PROP_METHOD,
+  PROP_LAST
+};
+
+struct _GstWebVideoScale
+{
+  GstBaseTransform element;
+
+  /*< private >*/
+  GstVideoInfo in_info;
+  GstVideoInfo out_info;
+  GstWebCanvas *canvas;
+  GstWebVideoScaleMethod method;
+
+  /* Where the frames are scaled, on the runner */
+  val val_canvas;
+  val val_context;
+  /* Whether the copy of the frames from other runners was warned */
+  gboolean warned_foreign_runner;
+};
+
+typedef struct _GstWebVideoScaleData
+{
+  GstWebVideoScale *self;
+  GstWebRunner *runner;
+  /* The input VideoFrame, on our runner */
+  GstWebVideoFrame *video_frame;
+  GstWebVideoScaleMethod method;
+  GstClockTime pts;
+  GstClockTime duration;
+  GstWebVideoFrame *result;
+} GstWebVideoScaleData;
+
+G_DECLARE_FINAL_TYPE (GstWebVideoScale, gst_web_video_scale, GST,
+    WEB_VIDEO_SCALE, GstBaseTransform)
+G_DEFINE_TYPE (GstWebVideoScale, gst_web_video_scale,
+    GST_TYPE_BASE_TRANSFORM);
+GST_ELEMENT_REGISTER_DEFINE (web_video_scale, "webvideoscale",
+    GST_RANK_NONE, GST_TYPE_WEB_VIDEO_SCALE);
+GST_DEBUG_CATEGORY_STATIC (web_video_scale_debug);
+
+static GstStaticPadTemplate gst_web_video_scale_sink_pad_template =
+    GST_STATIC_PAD_TEMPLATE ("sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+        GST_STATIC_CAPS (DEFAULT_STATIC_CAPS));
+
+static GstStaticPadTemplate gst_web_video_scale_src_pad_template =
+    GST_STATIC_PAD_TEMPLATE ("src", GST_PAD_SRC, GST_PAD_ALWAYS,
+        GST_STATIC_CAPS (DEFAULT_STATIC_CAPS));
+
+static GType
+gst_web_video_scale_method_get_type (void)
+{
+  static gsize type = 0;
+  static const GEnumValue values[] = {
+    { GST_WEB_VIDEO_SCALE_METHOD_PIXELATED, "Nearest neighbour",
+        "pixelated" },
+    { GST_WEB_VIDEO_SCALE_METHOD_LOW, "Low quality smoothing", "low" },
+    { GST_WEB_VIDEO_SCALE_METHOD_MEDIUM, "Medium quality smoothing",
+        "medium" },
+    { GST_WEB_VIDEO_SCALE_METHOD_HIGH, "High quality smoothing", "high" },
+    { 0, NULL, NULL },
+  };
+
+  if (g_once_init_enter (&type)) {
+    GType _type = g_enum_register_static ("GstWebVideoScaleMethod", values);
+    g_once_init_leave (&type, _type);
+  }
+  return type;
+}
+
+static GstCaps *
+gst_web_video_scale_transform_caps (GstBaseTransform *bt,
+    GstPadDirection direction, GstCaps *caps, GstCaps *filter)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (bt);
+  GstCaps *tmp, *res;
+  guint i;
+
+  GST_DEBUG_OBJECT (self, "caps: %" GST_PTR_FORMAT, caps);
+  GST_DEBUG_OBJECT (self, "filter: %" GST_PTR_FORMAT, filter);
+  GST_DEBUG_OBJECT (self, "direction: %d", (int) direction);
+
+  /* Passthrough first, then any size, scaled to RGBA from any format */
+  tmp = gst_caps_new_empty ();
+  for (i = 0; i < gst_caps_get_size (caps); i++) {
+    GstStructure *s = gst_caps_get_structure (caps, i);
+    GstCapsFeatures *features;
+    GstStructure *scaled;
+
+    scaled = gst_structure_copy (s);
+    gst_structure_set (scaled, "format", G_TYPE_STRING, SCALED_FORMAT, NULL);
+    if (direction == GST_PAD_SRC) {
+      /* Only the scaled format can have a different size */
+      if (!gst_structure_can_intersect (s, scaled)) {
+        gst_structure_free (scaled);
+        continue;
+      }
+      gst_structure_remove_field (scaled, "format");
+    }
+    gst_structure_set (scaled, "width", GST_TYPE_INT_RANGE, 1, G_MAXINT,
+        "height", GST_TYPE_INT_RANGE, 1, G_MAXINT, NULL);
+    gst_structure_remove_fields (
+        scaled, "pixel-aspect-ratio", "colorimetry", "chroma-site", NULL);
+    features = gst_caps_get_features (caps, i);
+    gst_caps_append_structure_full (
+        tmp, scaled, features ? gst_caps_features_copy (features) : NULL);
+  }
+  tmp = gst_caps_merge (gst_caps_ref (caps), tmp);
+
+  if (filter) {
+    res = gst_caps_intersect_full (filter, tmp, GST_CAPS_INTERSECT_FIRST);
+    gst_caps_unref (tmp);
+  } else {
+    res = tmp;
+  }
+
+  GST_DEBUG_OBJECT (self, "Transformed caps to %" GST_PTR_FORMAT, res);
+
+  return res;
+}
+
+/* Keeps the display aspect ratio of the input for the dimensions downstream
+ * leaves open */
+static GstCaps *
+gst_web_video_scale_fixate_caps (GstBaseTransform *bt,
+    GstPadDirection direction, GstCaps *caps, GstCaps *othercaps)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (bt);
+  GstStructure *ins, *outs;
+  const gchar *format;
+  gint from_w, from_h;
+  gint w = 0, h = 0;
+
+  othercaps = gst_caps_truncate (othercaps);
+  othercaps = gst_caps_make_writable (othercaps);
+  if (direction != GST_PAD_SINK)
+    return gst_caps_fixate (othercaps);
+
+  ins = gst_caps_get_structure (caps, 0);
+  outs = gst_caps_get_structure (othercaps, 0);
+  if (!gst_structure_get_int (ins, "width", &from_w) ||
+      !gst_structure_get_int (ins, "height", &from_h) || !from_w || !from_h)
+    return gst_caps_fixate (othercaps);
+
+  /* Do not convert when not needed */
+  format = gst_structure_get_string (ins, "format");
+  if (format)
+    gst_structure_fixate_field_string (outs, "format", format);
+
+  gst_structure_get_int (outs, "width", &w);
+  gst_structure_get_int (outs, "height", &h);
+  if (w && !h) {
+    gst_structure_fixate_field_nearest_int (
+        outs, "height", gst_util_uint64_scale_int (w, from_h, from_w));
+  } else if (h && !w) {
+    gst_structure_fixate_field_nearest_int (
+        outs, "width", gst_util_uint64_scale_int (h, from_w, from_h));
+  } else if (!w && !h) {
+    gst_structure_fixate_field_nearest_int (outs, "width", from_w);
+    gst_structure_get_int (outs, "width", &w);
+    gst_structure_fixate_field_nearest_int (
+        outs, "height", gst_util_uint64_scale_int (w, from_h, from_w));
+  }
+  othercaps = gst_caps_fixate (othercaps);
+
+  GST_DEBUG_OBJECT (self, "Fixated to %" GST_PTR_FORMAT, othercaps);
+
+  return othercaps;
+}
+
+static gboolean
+gst_web_video_scale_set_caps (
+    GstBaseTransform *bt, GstCaps *in_caps, GstCaps *out_caps)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (bt);
+
+  if (!gst_video_info_from_caps (&self->in_info, in_caps) ||
+      !gst_video_info_from_caps (&self->out_info, out_caps))
+    return FALSE;
+
+  GST_INFO_OBJECT (self, "Scaling from %dx%d %s to %dx%d %s",
+      GST_VIDEO_INFO_WIDTH (&self->in_info),
+      GST_VIDEO_INFO_HEIGHT (&self->in_info),
+      gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&self->in_info)),
+      GST_VIDEO_INFO_WIDTH (&self->out_info),
+      GST_VIDEO_INFO_HEIGHT (&self->out_info),
+      gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&self->out_info)));
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_web_video_scale_prepare_output_buffer (
+    GstBaseTransform *bt, GstBuffer *inbuf, GstBuffer **outbuf)
+{
+  if (gst_base_transform_is_passthrough (bt)) {
+    *outbuf = inbuf;
+    return GST_FLOW_OK;
+  }
+
+  /* The metas too, as the overlay compositions, the base class does not
+   * copy them when the output buffer is prepared here */
+  *outbuf = gst_buffer_new ();
+  gst_buffer_copy_into (*outbuf, inbuf,
+      GstBufferCopyFlags (GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS |
+                          GST_BUFFER_COPY_META),
+      0, -1);
+  return GST_FLOW_OK;
+}
+
+static void
+gst_web_video_scale_scale (gpointer data)
+{
+  GstWebVideoScaleData *scale_data = (GstWebVideoScaleData *) data;
+  GstWebVideoScale *self = scale_data->self;
+  gint width = GST_VIDEO_INFO_WIDTH (&self->out_info);
+  gint height = GST_VIDEO_INFO_HEIGHT (&self->out_info);
+  val init = val::object ();
+  val video_frame;
+
+  /* Reuse the canvas while the output size does not change */
+  if (self->val_canvas.isUndefined () ||
+      self->val_canvas["width"].as<int> () != width ||
+      self->val_canvas["height"].as<int> () != height) {
+    GST_DEBUG_OBJECT (self, "Creating a %dx%d canvas", width, height);
+    self->val_canvas = val::global ("OffscreenCanvas").new_ (width, height);
+    self->val_context =
+        self->val_canvas.call<val> ("getContext", std::string ("2d"));
+  }
+
+  switch (scale_data->method) {
+    case GST_WEB_VIDEO_SCALE_METHOD_PIXELATED:
+      self->val_context.set ("imageSmoothingEnabled", false);
+      break;
+    case GST_WEB_VIDEO_SCALE_METHOD_LOW:
+      self->val_context.set ("imageSmoothingEnabled", true);
+      self->val_context.set ("imageSmoothingQuality", std::string ("low"));
+      break;
+    case GST_WEB_VIDEO_SCALE_METHOD_MEDIUM:
+      self->val_context.set ("imageSmoothingEnabled", true);
+      self->val_context.set ("imageSmoothingQuality", std::string ("medium"));
+      break;
+    case GST_WEB_VIDEO_SCALE_METHOD_HIGH:
+      self->val_context.set ("imageSmoothingEnabled", true);
+      self->val_context.set ("imageSmoothingQuality", std::string ("high"));
+      break;
+  }
+  self->val_context.call<void> ("drawImage",
+      gst_web_video_frame_get_handle (scale_data->video_frame), 0, 0, width,
+      height);
+
+  init.set ("timestamp", GST_CLOCK_TIME_IS_VALID (scale_data->pts)
+                             ? (double) GST_TIME_AS_USECONDS (scale_data->pts)
+                             : 0.0);
+  if (GST_CLOCK_TIME_IS_VALID (scale_data->duration)) {
+    init.set (
+        "duration", (double) GST_TIME_AS_USECONDS (scale_data->duration));
+  }
+  video_frame = val::global ("VideoFrame").new_ (self->val_canvas, init);
+  scale_data->result =
+      gst_web_video_frame_wrap (video_frame, scale_data->runner);
+}
+
+static void
+gst_web_video_scale_teardown (gpointer data)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (data);
+
+  self->val_context = val::undefined ();
+  self->val_canvas = val::undefined ();
+}
+
+static GstFlowReturn
+gst_web_video_scale_transform (
+    GstBaseTransform *bt, GstBuffer *inbuf, GstBuffer *outbuf)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (bt);
+  GstWebVideoScaleData data = {};
+  GstWebVideoFrame *vf;
+  GstWebRunner *runner;
+  GstMemory *mem;
+
+  mem = gst_buffer_n_memory (inbuf) ? gst_buffer_peek_memory (inbuf, 0)
+                                    : NULL;
+  if (!mem || !gst_memory_is_type (mem, GST_WEB_VIDEO_FRAME_ALLOCATOR_NAME)) {
+    GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+        ("The input buffer has no VideoFrame"));
+    return GST_FLOW_ERROR;
+  }
+  vf = GST_WEB_VIDEO_FRAME_CAST (mem);
+
+  data.self = self;
+  data.runner = gst_web_canvas_get_runner (self->canvas);
+  data.pts = GST_BUFFER_PTS (inbuf);
+  data.duration = GST_BUFFER_DURATION (inbuf);
+  GST_OBJECT_LOCK (self);
+  data.method = self->method;
+  GST_OBJECT_UNLOCK (self);
+
+  /* The decoder might be running on its own runner */
+  runner = gst_web_video_frame_get_runner (vf);
+  if (runner != data.runner && !self->warned_foreign_runner) {
+    GST_ELEMENT_WARNING (self, STREAM, FORMAT,
+        ("Frames on another runner are copied through the CPU"),
+        ("Use runner-mode=shared in the decoder to avoid the copy"));
+    self->warned_foreign_runner = TRUE;
+  }
+  gst_object_unref (runner);
+  data.video_frame = gst_web_video_frame_import (vf, data.runner);
+  if (!data.video_frame) {
+    GST_ELEMENT_ERROR (self, RESOURCE, FAILED, (NULL),
+        ("Impossible to get the VideoFrame on our runner"));
+    gst_object_unref (data.runner);
+    return GST_FLOW_ERROR;
+  }
+
+  gst_web_runner_send_message (
+      data.runner, gst_web_video_scale_scale, &data);
+  gst_memory_unref (GST_MEMORY_CAST (data.video_frame));
+  gst_object_unref (data.runner);
+
+  if (!data.result) {
+    GST_ELEMENT_ERROR (self, RESOURCE, FAILED, (NULL),
+        ("Impossible to create the scaled VideoFrame"));
+    return GST_FLOW_ERROR;
+  }
+  gst_buffer_insert_memory (outbuf, -1, GST_MEMORY_CAST (data.result));
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+gst_web_video_scale_start (GstBaseTransform *bt)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (bt);
+  GstWebRunner *runner;
+  gboolean ret = FALSE;
+
+  if (!gst_web_utils_element_ensure_canvas (
+          GST_ELEMENT (self), &self->canvas, NULL)) {
+    GST_ERROR_OBJECT (self, "Failed requesting a WebCanvas context");
+    return FALSE;
+  }
+
+  runner = gst_web_canvas_get_runner (self->canvas);
+  if (!gst_web_runner_run (runner, NULL)) {
+    GST_ERROR_OBJECT (self, "Impossible to run the runner");
+    goto done;
+  }
+  self->warned_foreign_runner = FALSE;
+
+  ret = TRUE;
+done:
+  gst_object_unref (runner);
+  return ret;
+}
+
+static gboolean
+gst_web_video_scale_stop (GstBaseTransform *bt)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (bt);
+  GstWebRunner *runner;
+
+  if (self->canvas) {
+    runner = gst_web_canvas_get_runner (self->canvas);
+    gst_web_runner_send_message (runner, gst_web_video_scale_teardown, self);
+    gst_object_unref (runner);
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_web_video_scale_query (GstElement *element, GstQuery *query)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (element);
+  gboolean ret = FALSE;
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CONTEXT:
+      ret = gst_web_utils_element_handle_context_query (
+          element, query, self->canvas);
+      break;
+    default:
+      break;
+  }
+
+  if (!ret)
+    ret = GST_ELEMENT_CLASS (parent_class)->query (element, query);
+
+  return ret;
+}
+
+static void
+gst_web_video_scale_set_context (GstElement *element, GstContext *context)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (element);
+
+  gst_web_utils_element_set_context (element, context, &self->canvas);
+}
+
+static void
+gst_web_video_scale_set_property (
+    GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (object);
+
+  switch (prop_id) {
+    case PROP_METHOD:
+      GST_OBJECT_LOCK (self);
+      self->method = (GstWebVideoScaleMethod) g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_web_video_scale_get_property (
+    GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (object);
+
+  switch (prop_id) {
+    case PROP_METHOD:
+      GST_OBJECT_LOCK (self);
+      g_value_set_enum (value, self->method);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_web_video_scale_init (GstWebVideoScale *self)
+{
+  gst_base_transform_set_prefer_passthrough (GST_BASE_TRANSFORM (self), TRUE);
+  self->method = DEFAULT_METHOD;
+  self->val_canvas = val::undefined ();
+  self->val_context = val::undefined ();
+}
+
+static void
+gst_web_video_scale_dispose (GObject *gobj)
+{
+  GstWebVideoScale *self = GST_WEB_VIDEO_SCALE (gobj);
+
+  gst_clear_object (&self->canvas);
+
+  G_OBJECT_CLASS (parent_class)->dispose (gobj);
+}
+
+static void
+gst_web_video_scale_class_init (GstWebVideoScaleClass *klass)
+{
+  GstBaseTransformClass *gstbasetransform_class;
+  GstElementClass *gstelement_class;
+  GObjectClass *gobject_class;
+
+  gstbasetransform_class = (GstBaseTransformClass *) klass;
+  gstelement_class = (GstElementClass *) klass;
+  gobject_class = (GObjectClass *) klass;
+
+  gstbasetransform_class->transform_caps =
+      gst_web_video_scale_transform_caps;
+  gstbasetransform_class->fixate_caps = gst_web_video_scale_fixate_caps;
+  gstbasetransform_class->set_caps = gst_web_video_scale_set_caps;
+  gstbasetransform_class->passthrough_on_same_caps = TRUE;
+  gstbasetransform_class->transform = gst_web_video_scale_transform;
+  gstbasetransform_class->prepare_output_buffer =
+      gst_web_video_scale_prepare_output_buffer;
+  gstbasetransform_class->start = gst_web_video_scale_start;
+  gstbasetransform_class->stop = gst_web_video_scale_stop;
+
+  gstelement_class->query = gst_web_video_scale_query;
+  gstelement_class->set_context = gst_web_video_scale_set_context;
+
+  gst_element_class_set_static_metadata (gstelement_class,
+      "Web Video Scale", "Filter/Converter/Video/Scaler",
+      "Scales VideoFrames (memory) with the browser", GST_WEB_AUTHOR);
+
+  gst_element_class_add_static_pad_template (
+      gstelement_class, &gst_web_video_scale_src_pad_template);
+  gst_element_class_add_static_pad_template (
+      gstelement_class, &gst_web_video_scale_sink_pad_template);
+
+  gobject_class->dispose = gst_web_video_scale_dispose;
+  gobject_class->set_property = gst_web_video_scale_set_property;
+  gobject_class->get_property = gst_web_video_scale_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_METHOD,
+      g_param_spec_enum ("method", "Method",
+          "The smoothing used when scaling, as the resizeQuality of "
+          "createImageBitmap()",
+          GST_TYPE_WEB_VIDEO_SCALE_METHOD, DEFAULT_METHOD,
+          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+  GST_DEBUG_CATEGORY_INIT (
+      web_video_scale_debug, "webvideoscale", 0, "Web Video Scale");
+}
@@ -0,0 +1,227 @@
+/*
+ * GStreamer - gst.wasm WebSimd tests
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks the pixel format kernels against plain C references, with odd
+ * sizes to go through the scalar leftovers too, and the lossless frame
+ * conversions against GstVideoConverter. Exits with an error on any
+ * mismatch, it is built with and without SIMD128.
+ */
+
+#include <string.h>
+#include <gst/web/gstwebsimd.h>
+
+#define WIDTH 67
+#define HEIGHT 33
+
+typedef struct
+{
+  const gchar *name;
+  GstVideoFormat in_format;
+  GstVideoFormat out_format;
+} Conversion;
+
+static const Conversion conversions[] = {
+  { "NV12 to I420", GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420 },
+  { "I420 to NV12", GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12 },
+  { "RGBA to BGRA", GST_VIDEO_FORMAT_RGBA, GST_VIDEO_FORMAT_BGRA },
+  { "BGRx to RGBA", GST_VIDEO_FORMAT_BGRx, GST_VIDEO_FORMAT_RGBA },
+  { "RGBx to RGBA", GST_VIDEO_FORMAT_RGBx, GST_VIDEO_FORMAT_RGBA },
+};
+
+/* Sizes of every length modulo the vector size */
+static const gsize sizes[] = { 1, 3, 15, 16, 17, 31, 33, 64, 1001 };
+
+static void
+fill_random (guint8 *data, gsize size)
+{
+  gsize i;
+
+  for (i = 0; i < size; i++)
+    data[i] = g_random_int_range (0, 256);
+}
+
+static gboolean
+check_kernels (gsize n)
+{
+  guint8 *a = g_malloc (4 * n);
+  guint8 *b = g_malloc (4 * n);
+  guint8 *c = g_malloc (4 * n);
+  guint16 *w = g_new (guint16, n);
+  gboolean ret = TRUE;
+  gsize j;
+
+  fill_random (a, 4 * n);
+  for (j = 0; j < n; j++)
+    w[j] = g_random_int_range (0, 1024);
+
+  gst_web_simd_deinterleave_uv (a, b, c, n);
+  for (j = 0; j < n; j++) {
+    if (b[j] != a[2 * j] || c[j] != a[2 * j + 1]) {
+      g_printerr ("deinterleave_uv of %" G_GSIZE_FORMAT " failed\n", n);
+      ret = FALSE;
+      break;
+    }
+  }
+
+  gst_web_simd_interleave_uv (b, c, a + 2 * n, n);
+  if (memcmp (a, a + 2 * n, 2 * n)) {
+    g_printerr ("interleave_uv of %" G_GSIZE_FORMAT " failed\n", n);
+    ret = FALSE;
+  }
+
+  fill_random (a, 4 * n);
+  gst_web_simd_swap_rb (a, b, n);
+  for (j = 0; j < n; j++) {
+    if (b[4 * j] != a[4 * j + 2] || b[4 * j + 1] != a[4 * j + 1] ||
+        b[4 * j + 2] != a[4 * j] || b[4 * j + 3] != a[4 * j + 3]) {
+      g_printerr ("swap_rb of %" G_GSIZE_FORMAT " failed\n", n);
+      ret = FALSE;
+      break;
+    }
+  }
+  /* In place */
+  gst_web_simd_swap_rb (b, b, n);
+  if (memcmp (a, b, 4 * n)) {
+    g_printerr ("swap_rb in place of %" G_GSIZE_FORMAT " failed\n", n);
+    ret = FALSE;
+  }
+
+  gst_web_simd_fill_alpha (b, n);
+  for (j = 0; j < n; j++) {
+    if (b[4 * j + 3] != 0xff || memcmp (a + 4 * j, b + 4 * j, 3)) {
+      g_printerr ("fill_alpha of %" G_GSIZE_FORMAT " failed\n", n);
+      ret = FALSE;
+      break;
+    }
+  }
+
+  gst_web_simd_unpack_10le (w, b, n);
+  for (j = 0; j < n; j++) {
+    if (b[j] != w[j] >> 2) {
+      g_printerr ("unpack_10le of %" G_GSIZE_FORMAT " failed\n", n);
+      ret = FALSE;
+      break;
+    }
+  }
+
+  g_free (w);
+  g_free (c);
+  g_free (b);
+  g_free (a);
+
+  return ret;
+}
+
+static GstBuffer *
+new_frame_buffer (GstVideoInfo *info)
+{
+  GstBuffer *buffer = gst_buffer_new_allocate (NULL, info->size, NULL);
+  GstMapInfo map;
+
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  fill_random (map.data, map.size);
+  gst_buffer_unmap (buffer, &map);
+
+  return buffer;
+}
+
+/* The swizzles and plane shuffles are lossless, the kernels must give the
+ * same result than GstVideoConverter */
+static gboolean
+check_conversion (const Conversion *conv)
+{
+  GstVideoInfo in_info, out_info;
+  GstVideoFrame in_frame, out_frame, ref_frame;
+  GstVideoConverter *converter;
+  GstBuffer *inbuf, *outbuf, *refbuf;
+  gboolean ret = TRUE;
+  guint i;
+
+  gst_video_info_set_format (&in_info, conv->in_format, WIDTH, HEIGHT);
+  gst_video_info_set_format (&out_info, conv->out_format, WIDTH, HEIGHT);
+  inbuf = new_frame_buffer (&in_info);
+  outbuf = gst_buffer_new_allocate (NULL, out_info.size, NULL);
+  refbuf = gst_buffer_new_allocate (NULL, out_info.size, NULL);
+  gst_video_frame_map (&in_frame, &in_info, inbuf, GST_MAP_READ);
+  gst_video_frame_map (&out_frame, &out_info, outbuf, GST_MAP_WRITE);
+  gst_video_frame_map (&ref_frame, &out_info, refbuf, GST_MAP_WRITE);
+
+  if (!gst_web_simd_convert_frame (&in_frame, &out_frame)) {
+    g_printerr ("%s is not handled\n", conv->name);
+    ret = FALSE;
+    goto done;
+  }
+
+  converter = gst_video_converter_new (&in_info, &out_info,
+      gst_structure_new ("options", GST_VIDEO_CONVERTER_OPT_DITHER_METHOD,
+          GST_TYPE_VIDEO_DITHER_METHOD, GST_VIDEO_DITHER_NONE, NULL));
+  gst_video_converter_frame (converter, &in_frame, &ref_frame);
+  gst_video_converter_free (converter);
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (&out_frame) && ret; i++) {
+    gsize row = GST_VIDEO_FRAME_COMP_WIDTH (&out_frame, i) *
+                GST_VIDEO_FRAME_COMP_PSTRIDE (&out_frame, i);
+    gint j;
+
+    for (j = 0; j < GST_VIDEO_FRAME_COMP_HEIGHT (&out_frame, i); j++) {
+      if (memcmp ((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&out_frame, i) +
+                      j * GST_VIDEO_FRAME_PLANE_STRIDE (&out_frame, i),
+              (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&ref_frame, i) +
+                  j * GST_VIDEO_FRAME_PLANE_STRIDE (&ref_frame, i),
+              row)) {
+        g_printerr ("%s differs on plane %u row %d\n", conv->name, i, j);
+        ret = FALSE;
+        break;
+      }
+    }
+  }
+
+done:
+  gst_video_frame_unmap (&ref_frame);
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+  gst_buffer_unref (refbuf);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (inbuf);
+
+  return ret;
+}
+
+int
+main (int argc, char **argv)
+{
+  gboolean ret = TRUE;
+  guint i;
+
+  gst_init (NULL, NULL);
+
+  g_print ("Kernels built %s SIMD128\n",
+      gst_web_simd_is_accelerated () ? "with" : "without");
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++)
+    ret &= check_kernels (sizes[i]);
+  for (i = 0; i < G_N_ELEMENTS (conversions); i++)
+    ret &= check_conversion (&conversions[i]);
+  g_print ("Kernels check %s\n", ret ? "passed" : "FAILED");
+
+  return ret ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/*
+ * GStreamer - gst.wasm WebCodecs audio seek example
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Decodes an AAC stream with WebCodecs, seeks every few seconds and logs the
+ * time from the seek to the first decoded sample reaching the sink. A seek
+ * resets the decoder, nothing decoded before it must show up after the
+ * flush.
+ */
+
+#include <gst/emscripten/gstemscripten.h>
+
+#define DEFAULT_URL "https://hbbtv-demo.fluendo.com/bbb.mp4"
+#define SEEKS 10
+#define SEEK_STEP (20 * GST_SECOND)
+#define SEEK_TIMEOUT (5 * G_USEC_PER_SEC)
+
+#define GST_CAT_DEFAULT example_dbg
+GST_DEBUG_CATEGORY_STATIC (example_dbg);
+
+typedef struct
+{
+  GstElement *pipeline;
+  GMutex lock;
+  GCond cond;
+  /* Set by the seek, the first buffer after the flush clears it */
+  gboolean seeking;
+  gboolean flushed;
+  gint64 seek_time;
+  gint64 latency;
+} Measure;
+
+static Measure measure;
+
+static GstPadProbeReturn
+sink_probe (GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+  Measure *m = (Measure *) user_data;
+
+  g_mutex_lock (&m->lock);
+  if (info->type & GST_PAD_PROBE_TYPE_EVENT_FLUSH) {
+    if (GST_EVENT_TYPE (GST_PAD_PROBE_INFO_EVENT (info)) ==
+        GST_EVENT_FLUSH_STOP)
+      m->flushed = TRUE;
+  } else if (m->seeking && m->flushed) {
+    m->latency = g_get_monotonic_time () - m->seek_time;
+    m->seeking = FALSE;
+    g_cond_signal (&m->cond);
+  }
+  g_mutex_unlock (&m->lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static gpointer
+run_seeks (gpointer data)
+{
+  Measure *m = (Measure *) data;
+  gint64 total = 0, min = G_MAXINT64, max = 0;
+  gint64 end_time;
+  guint done = 0;
+  guint i;
+
+  gst_element_get_state (m->pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+  for (i = 1; i <= SEEKS; i++) {
+    gboolean timeout = FALSE;
+
+    g_usleep (G_USEC_PER_SEC);
+
+    g_mutex_lock (&m->lock);
+    m->seeking = TRUE;
+    m->flushed = FALSE;
+    m->seek_time = g_get_monotonic_time ();
+    g_mutex_unlock (&m->lock);
+
+    if (!gst_element_seek_simple (m->pipeline, GST_FORMAT_TIME,
+            (GstSeekFlags) (GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT),
+            i * SEEK_STEP)) {
+      GST_WARNING ("Seek to %" GST_TIME_FORMAT " failed",
+          GST_TIME_ARGS (i * SEEK_STEP));
+      continue;
+    }
+
+    end_time = g_get_monotonic_time () + SEEK_TIMEOUT;
+    g_mutex_lock (&m->lock);
+    while (m->seeking && !timeout)
+      timeout = !g_cond_wait_until (&m->cond, &m->lock, end_time);
+    m->seeking = FALSE;
+    g_mutex_unlock (&m->lock);
+
+    if (timeout) {
+      GST_WARNING ("No sample after seeking to %" GST_TIME_FORMAT,
+          GST_TIME_ARGS (i * SEEK_STEP));
+      continue;
+    }
+
+    GST_INFO ("Seek to %" GST_TIME_FORMAT ": first sample after %"
+              G_GINT64_FORMAT " us",
+        GST_TIME_ARGS (i * SEEK_STEP), m->latency);
+    total += m->latency;
+    min = MIN (min, m->latency);
+    max = MAX (max, m->latency);
+    done++;
+  }
+
+  if (done) {
+    GST_INFO ("%u seeks: min %" G_GINT64_FORMAT " us, avg %" G_GINT64_FORMAT
+              " us, max %" G_GINT64_FORMAT " us",
+        done, min, total / done, max);
+  }
+  GST_INFO ("Done");
+
+  return NULL;
+}
+
+static void
+init_measure (Measure *m)
+{
+  GstElement *sink;
+  GstPad *pad;
+
+  g_mutex_init (&m->lock);
+  g_cond_init (&m->cond);
+
+  m->pipeline = gst_parse_launch (
+      "webstreamsrc location=" DEFAULT_URL " ! qtdemux ! audio/mpeg ! "
+      "webcodecsauddecaacsw ! fakesink name=sink sync=true",
+      NULL);
+
+  sink = gst_bin_get_by_name (GST_BIN (m->pipeline), "sink");
+  pad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_add_probe (pad,
+      (GstPadProbeType) (GST_PAD_PROBE_TYPE_BUFFER |
+                         GST_PAD_PROBE_TYPE_EVENT_FLUSH),
+      sink_probe, m, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (sink);
+
+  gst_element_set_state (m->pipeline, GST_STATE_PLAYING);
+}
+
+static void
+register_elements ()
+{
+  GST_PLUGIN_STATIC_DECLARE (coreelements);
+  GST_PLUGIN_STATIC_DECLARE (web);
+  GST_PLUGIN_STATIC_DECLARE (isomp4);
+
+  GST_PLUGIN_STATIC_REGISTER (coreelements);
+  GST_PLUGIN_STATIC_REGISTER (web);
+  GST_PLUGIN_STATIC_REGISTER (isomp4);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_debug_set_default_threshold (1);
+  gst_init (NULL, NULL);
+  gst_emscripten_init ();
+
+  GST_DEBUG_CATEGORY_INIT (
+      example_dbg, "example", 0, "webcodecs audio seek example");
+  gst_debug_set_threshold_from_string ("example:5", FALSE);
+
+  GST_INFO ("Registering elements");
+  register_elements ();
+
+  GST_INFO ("Initializing pipeline");
+  init_measure (&measure);
+
+  /* The seeks block until the first sample, do not block the main
+   * function */
+  g_thread_unref (g_thread_new ("seeks", run_seeks, &measure));
+
+  return 0;
+}
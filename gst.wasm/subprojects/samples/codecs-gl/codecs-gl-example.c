@@ -0,0 +1,83 @@
+/*
+ * GStreamer - gst.wasm WebCodecs to OpenGL example
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Decodes an H.264 stream with WebCodecs straight into GL textures rendered
+ * by glimagesink. The decoder runs on the GL thread and uploads every
+ * VideoFrame with texSubImage2D, no copy is done in wasm memory.
+ *
+ * It also runs on headless Chromium with a software GL implementation:
+ * chromium --headless --use-gl=angle --use-angle=swiftshader
+ */
+
+#include <gst/emscripten/gstemscripten.h>
+
+#define DEFAULT_URL "https://hbbtv-demo.fluendo.com/pip/bbb.mp4"
+
+GST_DEBUG_CATEGORY_STATIC (example_dbg);
+#define GST_CAT_DEFAULT example_dbg
+
+static GstElement *pipeline;
+
+static void
+register_elements ()
+{
+  GST_PLUGIN_STATIC_DECLARE (coreelements);
+  GST_PLUGIN_STATIC_DECLARE (isomp4);
+  GST_PLUGIN_STATIC_DECLARE (opengl);
+  GST_PLUGIN_STATIC_DECLARE (web);
+
+  GST_PLUGIN_STATIC_REGISTER (coreelements);
+  GST_PLUGIN_STATIC_REGISTER (isomp4);
+  GST_PLUGIN_STATIC_REGISTER (opengl);
+  GST_PLUGIN_STATIC_REGISTER (web);
+}
+
+static void
+init_pipeline ()
+{
+  pipeline = gst_parse_launch ("webstreamsrc location=" DEFAULT_URL
+                               " ! qtdemux ! webcodecsviddech264sw ! "
+                               "glimagesink",
+      NULL);
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_debug_set_default_threshold (2);
+  gst_init (NULL, NULL);
+  gst_emscripten_init ();
+
+  GST_DEBUG_CATEGORY_INIT (
+      example_dbg, "example", 0, "webcodecs to OpenGL example");
+  gst_debug_set_threshold_from_string ("example:5", FALSE);
+
+  GST_INFO ("Registering elements");
+  register_elements ();
+
+  GST_INFO ("Initializing pipeline");
+  init_pipeline ();
+
+  return 0;
+}
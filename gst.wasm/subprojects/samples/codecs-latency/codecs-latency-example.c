@@ -0,0 +1,228 @@
+/*
+ * GStreamer - gst.wasm WebCodecs latency example
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Runs the same stream through two WebCodecs decoders, one with
+ * low-latency=false and one with low-latency=true, and logs the time every
+ * frame takes from the decoder sink pad to the sink. We can't measure the
+ * real glass-to-glass latency from here, but decoder input to sink arrival
+ * is where optimizeForLatency makes the difference. The latency the decoder
+ * reports in the LATENCY query is logged too, every time it changes, to
+ * compare it with the measured one.
+ */
+
+#include <gst/emscripten/gstemscripten.h>
+
+#define DEFAULT_URL "https://hbbtv-demo.fluendo.com/pip/bbb.mp4"
+#define REPORT_INTERVAL 100
+/* Pointers are 32 bits on wasm32, milliseconds are enough to tell frames
+ * apart
+ */
+#define PTS_KEY(buf)                                                          \
+  GUINT_TO_POINTER (GST_TIME_AS_MSECONDS (GST_BUFFER_PTS (buf)))
+
+#define GST_CAT_DEFAULT example_dbg
+GST_DEBUG_CATEGORY_STATIC (example_dbg);
+
+typedef struct
+{
+  const gchar *name;
+  GstElement *pipeline;
+  GMutex lock;
+  /* PTS -> monotonic time when the frame entered the decoder */
+  GHashTable *pending;
+  guint frames;
+  gint64 total;
+  gint64 max;
+} Measure;
+
+static Measure measures[2];
+
+static GstPadProbeReturn
+decoder_probe (GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+  Measure *m = (Measure *) user_data;
+  GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER (info);
+  gint64 *now;
+
+  if (!GST_BUFFER_PTS_IS_VALID (buf))
+    return GST_PAD_PROBE_OK;
+
+  now = g_new (gint64, 1);
+  *now = g_get_monotonic_time ();
+  g_mutex_lock (&m->lock);
+  g_hash_table_insert (m->pending, PTS_KEY (buf), now);
+  g_mutex_unlock (&m->lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* The latency the decoder reports in the LATENCY query */
+static GstClockTime
+query_latency (Measure *m)
+{
+  GstElement *dec;
+  GstQuery *query;
+  GstClockTime min_latency = GST_CLOCK_TIME_NONE;
+
+  dec = gst_bin_get_by_name (GST_BIN (m->pipeline), "dec");
+  query = gst_query_new_latency ();
+  if (gst_element_query (dec, query))
+    gst_query_parse_latency (query, NULL, &min_latency, NULL);
+  else
+    GST_WARNING ("%s: the latency query failed", m->name);
+  gst_query_unref (query);
+  gst_object_unref (dec);
+
+  return min_latency;
+}
+
+static void
+report (Measure *m)
+{
+  GstClockTime min_latency = query_latency (m);
+
+  GST_INFO ("%s: %u frames, avg %" G_GINT64_FORMAT " us, max %" G_GINT64_FORMAT
+            " us, reported latency %" GST_TIME_FORMAT,
+      m->name, m->frames, m->total / m->frames, m->max,
+      GST_TIME_ARGS (min_latency));
+}
+
+/* The decoder posts a latency message every time its reported latency
+ * changes, log the new value right away */
+static GstBusSyncReply
+bus_sync_handler (GstBus *bus, GstMessage *msg, gpointer user_data)
+{
+  Measure *m = (Measure *) user_data;
+  GstClockTime min_latency;
+
+  if (GST_MESSAGE_TYPE (msg) != GST_MESSAGE_LATENCY)
+    return GST_BUS_PASS;
+
+  min_latency = query_latency (m);
+  GST_INFO ("%s: reported latency changed to %" GST_TIME_FORMAT, m->name,
+      GST_TIME_ARGS (min_latency));
+
+  return GST_BUS_PASS;
+}
+
+static GstPadProbeReturn
+sink_probe (GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+  Measure *m = (Measure *) user_data;
+  GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER (info);
+  gint64 *start;
+  gint64 delta;
+  gboolean do_report = FALSE;
+
+  if (!GST_BUFFER_PTS_IS_VALID (buf))
+    return GST_PAD_PROBE_OK;
+
+  g_mutex_lock (&m->lock);
+  start = (gint64 *) g_hash_table_lookup (m->pending, PTS_KEY (buf));
+  if (start) {
+    delta = g_get_monotonic_time () - *start;
+    g_hash_table_remove (m->pending, PTS_KEY (buf));
+    m->frames++;
+    m->total += delta;
+    m->max = MAX (m->max, delta);
+    do_report = m->frames % REPORT_INTERVAL == 0;
+  }
+  g_mutex_unlock (&m->lock);
+
+  if (do_report)
+    report (m);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+init_measure (Measure *m, const gchar *name, gboolean low_latency)
+{
+  GstElement *element;
+  GstBus *bus;
+  GstPad *pad;
+  gchar *desc;
+
+  m->name = name;
+  g_mutex_init (&m->lock);
+  m->pending = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+
+  desc = g_strdup_printf (
+      "webstreamsrc location=" DEFAULT_URL " ! qtdemux ! "
+      "webcodecsviddech264sw name=dec low-latency=%s ! "
+      "fakesink name=sink sync=true",
+      low_latency ? "true" : "false");
+  m->pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+
+  element = gst_bin_get_by_name (GST_BIN (m->pipeline), "dec");
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, decoder_probe, m, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (element);
+
+  element = gst_bin_get_by_name (GST_BIN (m->pipeline), "sink");
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, sink_probe, m, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (element);
+
+  bus = gst_element_get_bus (m->pipeline);
+  gst_bus_set_sync_handler (bus, bus_sync_handler, m, NULL);
+  gst_object_unref (bus);
+
+  gst_element_set_state (m->pipeline, GST_STATE_PLAYING);
+}
+
+static void
+register_elements ()
+{
+  GST_PLUGIN_STATIC_DECLARE (coreelements);
+  GST_PLUGIN_STATIC_DECLARE (web);
+  GST_PLUGIN_STATIC_DECLARE (isomp4);
+
+  GST_PLUGIN_STATIC_REGISTER (coreelements);
+  GST_PLUGIN_STATIC_REGISTER (web);
+  GST_PLUGIN_STATIC_REGISTER (isomp4);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_debug_set_default_threshold (1);
+  gst_init (NULL, NULL);
+  gst_emscripten_init ();
+
+  GST_DEBUG_CATEGORY_INIT (
+      example_dbg, "example", 0, "webcodecs latency example");
+  gst_debug_set_threshold_from_string ("example:5", FALSE);
+
+  GST_INFO ("Registering elements");
+  register_elements ();
+
+  GST_INFO ("Initializing pipelines");
+  init_measure (&measures[0], "default", FALSE);
+  init_measure (&measures[1], "low-latency", TRUE);
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * GStreamer - gst.wasm WebCodecs multi-stream scaling example
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Decodes the same stream with an increasing amount of decoders, for every
+ * runner-mode, as fast as possible, and logs the total amount of frames per
+ * second decoded for each combination.
+ */
+
+#include <gst/emscripten/gstemscripten.h>
+
+#define DEFAULT_URL "https://hbbtv-demo.fluendo.com/pip/bbb.mp4"
+#define MEASURE_SECONDS 10
+
+#define GST_CAT_DEFAULT example_dbg
+GST_DEBUG_CATEGORY_STATIC (example_dbg);
+
+static const guint decoder_counts[] = { 1, 2, 4, 9, 16 };
+static const gchar *runner_modes[] = { "shared", "dedicated", "pool", "auto" };
+
+static GstPadProbeReturn
+count_probe (GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+  gint *frames = (gint *) user_data;
+
+  g_atomic_int_inc (frames);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+measure (guint n_decoders, const gchar *runner_mode)
+{
+  GstElement *pipeline;
+  GString *desc;
+  gint frames = 0;
+  gint64 start;
+  gdouble elapsed;
+  guint i;
+
+  desc = g_string_new ("webstreamsrc location=" DEFAULT_URL
+                       " ! qtdemux ! tee name=t");
+  for (i = 0; i < n_decoders; i++) {
+    g_string_append_printf (desc,
+        " t. ! queue ! webcodecsviddech264sw runner-mode=%s ! "
+        "fakesink name=sink%u sync=false",
+        runner_mode, i);
+  }
+  pipeline = gst_parse_launch (desc->str, NULL);
+  g_string_free (desc, TRUE);
+
+  for (i = 0; i < n_decoders; i++) {
+    GstElement *sink;
+    GstPad *pad;
+    gchar *name;
+
+    name = g_strdup_printf ("sink%u", i);
+    sink = gst_bin_get_by_name (GST_BIN (pipeline), name);
+    pad = gst_element_get_static_pad (sink, "sink");
+    gst_pad_add_probe (
+        pad, GST_PAD_PROBE_TYPE_BUFFER, count_probe, &frames, NULL);
+    gst_object_unref (pad);
+    gst_object_unref (sink);
+    g_free (name);
+  }
+
+  start = g_get_monotonic_time ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  g_usleep (MEASURE_SECONDS * G_USEC_PER_SEC);
+  elapsed = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+  GST_INFO ("%2u decoders, runner-mode=%-9s: %7.1f fps total, %6.1f fps "
+            "per decoder",
+      n_decoders, runner_mode, g_atomic_int_get (&frames) / elapsed,
+      g_atomic_int_get (&frames) / elapsed / n_decoders);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+static gpointer
+run_measures (gpointer data)
+{
+  guint i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (decoder_counts); i++) {
+    for (j = 0; j < G_N_ELEMENTS (runner_modes); j++)
+      measure (decoder_counts[i], runner_modes[j]);
+  }
+  GST_INFO ("Done");
+
+  return NULL;
+}
+
+static void
+register_elements ()
+{
+  GST_PLUGIN_STATIC_DECLARE (coreelements);
+  GST_PLUGIN_STATIC_DECLARE (web);
+  GST_PLUGIN_STATIC_DECLARE (isomp4);
+
+  GST_PLUGIN_STATIC_REGISTER (coreelements);
+  GST_PLUGIN_STATIC_REGISTER (web);
+  GST_PLUGIN_STATIC_REGISTER (isomp4);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_debug_set_default_threshold (1);
+  gst_init (NULL, NULL);
+  gst_emscripten_init ();
+
+  GST_DEBUG_CATEGORY_INIT (
+      example_dbg, "example", 0, "webcodecs scaling example");
+  gst_debug_set_threshold_from_string ("example:5", FALSE);
+
+  GST_INFO ("Registering elements");
+  register_elements ();
+
+  /* Every measure blocks for a while, do not block the main function */
+  g_thread_unref (g_thread_new ("measures", run_measures, NULL));
+
+  return 0;
+}
@@ -0,0 +1,197 @@
+/*
+ * GStreamer - gst.wasm webcanvassink raw draw example
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Draws 1080p60 frames from system memory on a canvas of the same size with
+ * every raw path of webcanvassink: putImageData and an ImageBitmap
+ * transferred to a bitmaprenderer context for RGBA, a VideoFrame for YUV,
+ * and videoconvert to RGBA for YUV to compare with. Logs the frames
+ * presented and dropped by the sink, its draw time and its presentation
+ * jitter for each.
+ *
+ * The previous RGBA path, a copy into an ImageData and an awaited
+ * createImageBitmap(), is measured first on an OffscreenCanvas of the
+ * measures thread, as the baseline of the draw time.
+ *
+ * A canvas with a 2d context can not get a bitmaprenderer one, that path
+ * draws on its own canvas.
+ */
+
+#include <emscripten.h>
+#include <gst/emscripten/gstemscripten.h>
+
+#define FRAMES 600
+#define CAPS "width=1920,height=1080,framerate=60/1"
+
+#define GST_CAT_DEFAULT example_dbg
+GST_DEBUG_CATEGORY_STATIC (example_dbg);
+
+typedef struct
+{
+  const gchar *name;
+  const gchar *format;
+  const gchar *convert;
+  const gchar *sink;
+} Measure;
+
+static const Measure measures[] = {
+  { "RGBA, putImageData", "RGBA", "", "" },
+  { "RGBA, bitmaprenderer", "RGBA", "",
+      "draw-mode=bitmaprenderer id=#canvas-bitmap" },
+  { "I420, VideoFrame", "I420", "", "" },
+  { "I420, videoconvert to RGBA", "I420",
+      "videoconvert ! video/x-raw,format=RGBA ! ", "" },
+  { "NV12, VideoFrame", "NV12", "", "" },
+};
+
+/* Draws @frames RGBA frames as the sink used to and returns the average
+ * time per frame in milliseconds */
+EM_ASYNC_JS (double, measure_image_bitmap,
+    (const guint8 *data, int width, int height, int frames), {
+  const canvas = new OffscreenCanvas (width, height);
+  const ctx = canvas.getContext ("2d");
+  const view = HEAPU8.subarray (data, data + width * height * 4);
+  const start = performance.now ();
+
+  for (let i = 0; i < frames; i++) {
+    const image = new ImageData (new Uint8ClampedArray (view), width, height);
+    const bitmap = await createImageBitmap (image);
+
+    ctx.drawImage (bitmap, 0, 0);
+    bitmap.close ();
+  }
+
+  return (performance.now () - start) / frames;
+});
+
+static void
+measure_baseline (void)
+{
+  guint8 *data;
+  gdouble draw_time;
+  gsize i;
+
+  data = g_malloc (1920 * 1080 * 4);
+  for (i = 0; i < 1920 * 1080 * 4; i++)
+    data[i] = i & 0xff;
+  draw_time = measure_image_bitmap (data, 1920, 1080, FRAMES);
+  g_free (data);
+
+  GST_INFO ("%-30s: draw %.3f ms, %5.1f fps at most",
+      "RGBA, ImageData + ImageBitmap", draw_time, 1000.0 / draw_time);
+}
+
+static void
+measure (const Measure *m)
+{
+  GstElement *pipeline;
+  GstElement *sink;
+  GstMessage *msg;
+  gchar *desc;
+  guint64 presented, dropped;
+  guint64 draw_time = 0, jitter = 0;
+  GstStructure *stats;
+  gint64 start;
+  gdouble elapsed;
+
+  desc = g_strdup_printf ("videotestsrc is-live=true num-buffers=%d ! "
+                          "video/x-raw,format=%s," CAPS " ! %s"
+                          "webcanvassink name=sink %s",
+      FRAMES, m->format, m->convert, m->sink);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+
+  start = g_get_monotonic_time ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE,
+      (GstMessageType) (GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  elapsed = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    GST_ERROR ("%s failed: %" GST_PTR_FORMAT, m->name, msg);
+  } else {
+    sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+    g_object_get (sink, "presented", &presented, "dropped", &dropped,
+        "stats", &stats, NULL);
+    gst_structure_get_uint64 (stats, "average-draw-time", &draw_time);
+    gst_structure_get_uint64 (stats, "jitter", &jitter);
+    gst_structure_free (stats);
+    gst_object_unref (sink);
+    GST_INFO ("%-30s: %" G_GUINT64_FORMAT " presented, %" G_GUINT64_FORMAT
+              " dropped, %5.1f fps, draw %" GST_TIME_FORMAT
+              ", jitter %" GST_TIME_FORMAT,
+        m->name, presented, dropped, presented / elapsed,
+        GST_TIME_ARGS (draw_time), GST_TIME_ARGS (jitter));
+  }
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+static gpointer
+run_measures (gpointer data)
+{
+  guint i;
+
+  measure_baseline ();
+  for (i = 0; i < G_N_ELEMENTS (measures); i++)
+    measure (&measures[i]);
+  GST_INFO ("Done");
+
+  return NULL;
+}
+
+static void
+register_elements ()
+{
+  GST_PLUGIN_STATIC_DECLARE (coreelements);
+  GST_PLUGIN_STATIC_DECLARE (web);
+  GST_PLUGIN_STATIC_DECLARE (videotestsrc);
+  GST_PLUGIN_STATIC_DECLARE (videoconvertscale);
+
+  GST_PLUGIN_STATIC_REGISTER (coreelements);
+  GST_PLUGIN_STATIC_REGISTER (web);
+  GST_PLUGIN_STATIC_REGISTER (videotestsrc);
+  GST_PLUGIN_STATIC_REGISTER (videoconvertscale);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_debug_set_default_threshold (1);
+  gst_init (NULL, NULL);
+  gst_emscripten_init ();
+
+  GST_DEBUG_CATEGORY_INIT (
+      example_dbg, "example", 0, "webcanvassink raw draw example");
+  gst_debug_set_threshold_from_string ("example:5", FALSE);
+
+  GST_INFO ("Registering elements");
+  register_elements ();
+
+  /* Every measure blocks until EOS, do not block the main function */
+  g_thread_unref (g_thread_new ("measures", run_measures, NULL));
+
+  return 0;
+}
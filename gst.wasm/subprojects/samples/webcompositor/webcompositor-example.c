@@ -0,0 +1,94 @@
+/*
+ * GStreamer - gst.wasm webcompositor example
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+
+/*
+ * Composites four inputs in a 2x2 grid with webcompositor, plus a fifth one
+ * on top of them, translucent, and draws the result on the canvas with
+ * webcanvassink. Every input is uploaded to a VideoFrame, the composition
+ * is done by the browser.
+ */
+
+#include <gst/emscripten/gstemscripten.h>
+
+#define TILE_CAPS "video/x-raw,width=640,height=360,framerate=30/1"
+
+#define GST_CAT_DEFAULT example_dbg
+GST_DEBUG_CATEGORY_STATIC (example_dbg);
+
+static GstElement *pipeline;
+
+static void
+register_elements ()
+{
+  GST_PLUGIN_STATIC_DECLARE (coreelements);
+  GST_PLUGIN_STATIC_DECLARE (web);
+  GST_PLUGIN_STATIC_DECLARE (videotestsrc);
+
+  GST_PLUGIN_STATIC_REGISTER (coreelements);
+  GST_PLUGIN_STATIC_REGISTER (web);
+  GST_PLUGIN_STATIC_REGISTER (videotestsrc);
+}
+
+static void
+init_pipeline ()
+{
+  GST_DEBUG ("Init pipeline");
+
+  pipeline = gst_parse_launch (
+      "webcompositor name=c "
+      "sink_1::xpos=640 sink_2::ypos=360 sink_3::xpos=640 sink_3::ypos=360 "
+      "sink_4::xpos=480 sink_4::ypos=270 sink_4::width=320 "
+      "sink_4::height=180 sink_4::alpha=0.7 sink_4::zorder=10 ! "
+      "webcanvassink "
+      "videotestsrc is-live=true ! " TILE_CAPS " ! webupload ! c.sink_0 "
+      "videotestsrc is-live=true pattern=ball ! " TILE_CAPS
+      " ! webupload ! c.sink_1 "
+      "videotestsrc is-live=true pattern=snow ! " TILE_CAPS
+      " ! webupload ! c.sink_2 "
+      "videotestsrc is-live=true pattern=pinwheel ! " TILE_CAPS
+      " ! webupload ! c.sink_3 "
+      "videotestsrc is-live=true pattern=smpte100 ! " TILE_CAPS
+      " ! webupload ! c.sink_4",
+      NULL);
+  g_assert (pipeline);
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_debug_set_default_threshold (1);
+  gst_init (NULL, NULL);
+  gst_emscripten_init ();
+
+  GST_DEBUG_CATEGORY_INIT (example_dbg, "example", 0, "webcompositor example");
+  gst_debug_set_threshold_from_string ("example:5,webcompositor:4", FALSE);
+
+  GST_INFO ("Registering elements");
+  register_elements ();
+
+  init_pipeline ();
+
+  return 0;
+}
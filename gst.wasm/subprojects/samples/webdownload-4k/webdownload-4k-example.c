@@ -0,0 +1,141 @@
+/*
+ * GStreamer - gst.wasm webdownload 4K throughput example
+ *
+ * Copyright 2025 Fluendo S.A.
+ *  @author: Jorge Zapata <jzapata@fluendo.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Uploads 4K frames to VideoFrames and downloads them back with an
+ * increasing webdownload max-inflight, as fast as possible, and logs the
+ * frames per second and the bandwidth of the download for each value.
+ */
+
+#include <gst/emscripten/gstemscripten.h>
+
+#define FRAMES 120
+#define WIDTH 3840
+#define HEIGHT 2160
+
+#define GST_CAT_DEFAULT example_dbg
+GST_DEBUG_CATEGORY_STATIC (example_dbg);
+
+static const guint max_inflights[] = { 1, 2, 4, 8 };
+
+static GstPadProbeReturn
+count_probe (GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+  gint *frames = (gint *) user_data;
+
+  g_atomic_int_inc (frames);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+measure (guint max_inflight)
+{
+  GstElement *pipeline;
+  GstElement *sink;
+  GstMessage *msg;
+  GstPad *pad;
+  gchar *desc;
+  gint frames = 0;
+  gint64 start;
+  gdouble elapsed;
+
+  desc = g_strdup_printf (
+      "videotestsrc num-buffers=%d ! "
+      "video/x-raw,format=RGBA,width=%d,height=%d ! webupload ! "
+      "webdownload max-inflight=%u ! video/x-raw,format=RGBA ! "
+      "fakesink name=sink sync=false",
+      FRAMES, WIDTH, HEIGHT, max_inflight);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  pad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_add_probe (
+      pad, GST_PAD_PROBE_TYPE_BUFFER, count_probe, &frames, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (sink);
+
+  start = g_get_monotonic_time ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE,
+      (GstMessageType) (GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  elapsed = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    GST_ERROR ("max-inflight=%u failed: %" GST_PTR_FORMAT, max_inflight, msg);
+  } else {
+    frames = g_atomic_int_get (&frames);
+    GST_INFO ("max-inflight=%u: %d frames, %6.1f fps, %7.1f MB/s",
+        max_inflight, frames, frames / elapsed,
+        frames * (WIDTH * HEIGHT * 4.0) / elapsed / (1024 * 1024));
+  }
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+static gpointer
+run_measures (gpointer data)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (max_inflights); i++)
+    measure (max_inflights[i]);
+  GST_INFO ("Done");
+
+  return NULL;
+}
+
+static void
+register_elements ()
+{
+  GST_PLUGIN_STATIC_DECLARE (coreelements);
+  GST_PLUGIN_STATIC_DECLARE (web);
+  GST_PLUGIN_STATIC_DECLARE (videotestsrc);
+
+  GST_PLUGIN_STATIC_REGISTER (coreelements);
+  GST_PLUGIN_STATIC_REGISTER (web);
+  GST_PLUGIN_STATIC_REGISTER (videotestsrc);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_debug_set_default_threshold (1);
+  gst_init (NULL, NULL);
+  gst_emscripten_init ();
+
+  GST_DEBUG_CATEGORY_INIT (
+      example_dbg, "example", 0, "webdownload 4K throughput example");
+  gst_debug_set_threshold_from_string ("example:5", FALSE);
+
+  GST_INFO ("Registering elements");
+  register_elements ();
+
+  /* Every measure blocks until EOS, do not block the main function */
+  g_thread_unref (g_thread_new ("measures", run_measures, NULL));
+
+  return 0;
+}